@@ -39,7 +39,11 @@
 ## If the function is called with two outputs @var{gmsh_out} is the verbose output
 ## of the gmsh subprocess.
 ##
-## @seealso{msh2m_structured_mesh, msh3m_gmsh, msh2m_mesh_along_spline}
+## If the package was built with the gmsh library, the mesh is generated
+## within the Octave process by @code{mshm_gmsh}, with no subprocess and
+## no temporary files, unless an option is not supported by it.
+##
+## @seealso{msh2m_structured_mesh, msh3m_gmsh, msh2m_mesh_along_spline, mshm_gmsh}
 ## @end deftypefn
 
 function [mesh, gmsh_output] = msh2m_gmsh (geometry, varargin)
@@ -50,6 +54,18 @@ function [mesh, gmsh_output] = msh2m_gmsh (geometry, varargin)
   endif
   ## FIXME: add input type check?
 
+  ## Use the gmsh library if available
+  if (exist ("mshm_gmsh") == 3 && mshm_gmsh ("available"))
+    try
+      [mesh, gmsh_output] = mshm_gmsh (geometry, 2, varargin{:});
+      return;
+    catch err
+      if (! strcmp (err.identifier, "msh:gmsh-option"))
+        rethrow (err);
+      endif
+    end_try_catch
+  endif
+
   ## Build mesh
   noptions  = (nargin - 1) / 2; # Number of passed options
   
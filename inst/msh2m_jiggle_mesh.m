@@ -61,11 +61,9 @@ function [msh] = msh2m_jiggle_mesh(msh,steps)
   vnodes = setdiff(1:nnodes,dnodes);
 
   ## Find node neighbours 
-  ## FIXME: should this go into msh2m_topological_properties ?
-  sides = msh2m_topological_properties(msh,"sides");
+  v2v = msh2m_topological_properties(msh,"v2v");
   for inode = 1:nnodes
-    neig{inode} = (sides(:, sides(1,:) == inode | sides(2,:) == inode))(:);
-    neig{inode} (neig{inode} == inode) = [];
+    neig{inode} = v2v.idx(v2v.ptr(inode):v2v.ptr(inode+1)-1);
   endfor
 
   for istep = 1:steps
@@ -26,8 +26,13 @@
 ## Return a list of @var{mesh} nodes lying on the sides specified in
 ## @var{sidelist}.
 ##
+## If @var{mesh} has a field @code{bindex} built by
+## @code{mshm_boundary_index}, the nodes are obtained by merging the
+## lists stored in it for each side, which is faster when the function
+## is called many times on the same mesh.
+##
 ## @seealso{msh2m_geometrical_properties, msh2m_topological_properties,
-## msh3m_nodes_on_faces} 
+## msh3m_nodes_on_faces, mshm_boundary_index} 
 ## @end deftypefn
 
 function [nodelist] = msh2m_nodes_on_sides(mesh,sidelist)
@@ -43,16 +48,7 @@ function [nodelist] = msh2m_nodes_on_sides(mesh,sidelist)
   endif
 
   ## Search nodes
-
-  edgelist = [];
-  
-  for ii = 1:length(sidelist)
-    edgelist=[edgelist,find(mesh.e(5,:)==sidelist(ii))];
-  endfor
-
-  nodelist = mesh.e(1:2,edgelist);
-  nodelist = [nodelist(1,:) nodelist(2,:)];
-  nodelist = unique(nodelist);
+  nodelist = mshm_boundary_nodes(mesh,sidelist).';
 
 endfunction
 
@@ -63,3 +59,6 @@ endfunction
 %! [nodelist] = msh2m_nodes_on_sides(mesh,[1 2]);
 %! reallist = [1   4   7   8   9];
 %! assert(nodelist,reallist);
+%! mesh.bindex = mshm_boundary_index(mesh);
+%! assert(msh2m_nodes_on_sides(mesh,[1 2]),reallist);
+%! assert(msh2m_nodes_on_sides(mesh,[]),zeros(1,0));
@@ -67,7 +67,8 @@
 ## @end itemize 
 ##
 ## @seealso{msh3m_structured_mesh, msh2m_gmsh, msh2m_mesh_along_spline,
-## msh2m_join_structured_mesh, msh2m_submesh} 
+## msh2m_join_structured_mesh, msh2m_submesh,
+## mshm_implicit_mesh}
 ## @end deftypefn
 
 function [mesh] = msh2m_structured_mesh(x,y,region,sides,varargin)
@@ -45,15 +45,25 @@
 ## @item @code{"boundary"}: return a matrix with size 2 times the number
 ## of side edges. The first row contains the mesh element to which the
 ## side belongs, the second row is the local index of this edge.
+## @item @code{"v2c"}, @code{"v2v"}, @code{"c2c"}: return a structure
+## with the fields @code{ptr} and @code{idx} containing respectively the
+## elements around each node, the nodes connected by a side to each node
+## and the neighbours of each element in compressed sparse row form.
+## @item @code{"pattern"}: return the sparsity pattern of the matrices
+## assembled on the mesh with linear elements.
 ## @end itemize 
 ##
+## See @code{mshm_adjacency} for a description of the last four
+## properties, which are computed by compiled code.
+##
 ## The output will contain the geometrical properties requested in the
 ## input in the same order specified in the function call.
 ##
 ## If an unexpected string is given as input, an empty vector is
 ## returned in output.
 ##
-## @seealso{mshm2m_geometrical_properties, msh3m_geometrical_properties}
+## @seealso{mshm2m_geometrical_properties, msh3m_geometrical_properties,
+## msh3m_topological_properties, mshm_adjacency}
 ## @end deftypefn
 
 function [varargout] = msh2m_topological_properties(mesh,varargin)
@@ -131,6 +141,13 @@ function [varargout] = msh2m_topological_properties(mesh,varargin)
           clear b
 	endif
 
+      case {"v2c", "v2v", "c2c", "pattern"} # CSR adjacency
+	if isfield(mesh,request)
+          varargout{nn} = mesh.(request);
+	else
+          varargout{nn} = mshm_adjacency(mesh,request);
+	endif
+
       otherwise
 	warning("msh2m_topological_properties: unexpected value in property string. Empty vector passed as output.")
 	varargout{nn} = [];
@@ -260,6 +277,20 @@ endfunction
 %! assert(mesh.coinc,coinc);
 %! assert(mesh.boundary,boundary);
 
+%!test
+%! [mesh] = msh2m_structured_mesh(0:.5:1, 0:.5:1, 1, 1:4, "left");
+%! [n,sides,v2v,c2c,pattern] = msh2m_topological_properties(mesh,"n","sides","v2v","c2c","pattern");
+%! assert(c2c.ptr,[1; cumsum(sum(!isnan(n)))'+1]);
+%! assert(c2c.idx,n(!isnan(n)));
+%! for inode = 1:columns(mesh.p)
+%!   nb = (sides(:, sides(1,:) == inode | sides(2,:) == inode))(:);
+%!   nb(nb == inode) = [];
+%!   assert(v2v.idx(v2v.ptr(inode):v2v.ptr(inode+1)-1),sort(nb));
+%! endfor
+%! assert(nnz(pattern),columns(mesh.p)+2*columns(sides));
+%! mesh.v2v = "cached";
+%! assert(msh2m_topological_properties(mesh,"v2v"),"cached");
+
 %!test
 %! mesh.p = []; mesh.e = [];
 %! mesh.t = [3    9   10    1    6    9   10    9    8    9
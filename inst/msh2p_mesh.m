@@ -20,33 +20,118 @@
 ##  author: Massimiliano Culpo <culpo _AT_ users.sourceforge.net>
 
 ## -*- texinfo -*-
-## @deftypefn {Function File} msh2p_mesh(@var{mesh}, @var{linespec})
+## @deftypefn {Function File} {} msh2p_mesh (@var{mesh}, @var{linespec})
+## @deftypefnx {Function File} {} msh2p_mesh (@var{mesh}, @var{linespec}, @
+## @var{property}, @var{value}, @dots{})
+## @deftypefnx {Function File} {@var{h}} = msh2p_mesh (@dots{})
 ##
-## Plot @var{mesh} with the line specification in @var{linespec} using
-## @code{triplot}.
+## Plot the edges of @var{mesh} with the color, line style and marker
+## in @var{linespec} (default "r"), which has the same format as in
+## @code{plot}.  If @var{linespec} has a marker but no line style, only
+## the markers at the nodes are drawn.
 ##
-## @seealso{triplot}
+## Each edge is drawn once, in a single patch object whose handle is
+## returned in @var{h}, so that very large meshes can be inspected
+## interactively.  The properties "edges" and "budget" of
+## @code{mshm_plot_data} can be used to draw only the boundary and the
+## interfaces between regions, or to draw fewer interior edges.
+##
+## @seealso{mshm_plot_data, msh3p_mesh, triplot}
 ##
 ## @end deftypefn
 
-function msh2p_mesh(mesh,linespec)
+function h = msh2p_mesh (mesh, linespec, varargin)
 
   ## Check input
-  if nargin > 2
-    error("msh2p_mesh: wrong number of input parameters.");
-  elseif !(isstruct(mesh)     && isfield(mesh,"p") &&
-	   isfield (mesh,"t") && isfield(mesh,"e"))
-    error("msh2p_mesh: first input is not a valid mesh structure.");
+  if (nargin < 1 || (nargin > 2 && mod (nargin, 2) != 0))
+    error ("msh2p_mesh: wrong number of input parameters.");
+  elseif (! (isstruct (mesh) && isfield (mesh, "p") &&
+             isfield (mesh, "t") && isfield (mesh, "e")))
+    error ("msh2p_mesh: first input is not a valid mesh structure.");
   endif
 
-  tri = mesh.t(1:3,:)';
-  x   = mesh.p(1,:)';
-  y   = mesh.p(2,:)';
-  
-  if ~exist("linespec")
+  if (nargin < 2)
     linespec = "r";
   endif
 
-  triplot(tri,x,y,linespec);
-  
-endfunction
\ No newline at end of file
+  [color, style, marker] = parse_linespec (linespec);
+  [vertices, faces] = mshm_plot_data (mesh, varargin{:});
+
+  hh = patch ("Faces", faces, "Vertices", vertices, "FaceColor", "none",
+              "EdgeColor", color, "LineStyle", style, "Marker", marker,
+              "MarkerEdgeColor", color);
+  if (nargout > 0)
+    h = hh;
+  endif
+
+endfunction
+
+function [color, style, marker] = parse_linespec (linespec)
+
+  if (! ischar (linespec))
+    error ("msh2p_mesh: LINESPEC must be a string.");
+  endif
+
+  colors = "rgbcmykw";
+  values = [1 0 0; 0 1 0; 0 0 1; 0 1 1; 1 0 1; 1 1 0; 0 0 0; 1 1 1];
+  color  = values(1,:);
+  style  = "";
+  marker = "none";
+
+  k = 1;
+  while (k <= numel (linespec))
+    c = linespec(k);
+    if (any (c == colors))
+      color = values(colors == c,:);
+    elseif (c == "-" && k < numel (linespec) && any (linespec(k+1) == "-."))
+      style = linespec(k:k+1);
+      k++;
+    elseif (any (c == "-:"))
+      style = c;
+    elseif (any (c == "+o*.xsd^v<>ph"))
+      marker = c;
+    else
+      error ("msh2p_mesh: unsupported character '%s' in LINESPEC.", c);
+    endif
+    k++;
+  endwhile
+
+  if (isempty (style))
+    if (strcmp (marker, "none"))
+      style = "-";
+    else
+      style = "none";
+    endif
+  endif
+
+endfunction
+
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4);
+%! hf = figure ("visible", "off");
+%! unwind_protect
+%!   h = msh2p_mesh (mesh, "b--");
+%!   assert (get (h, "type"), "patch")
+%!   assert (get (h, "edgecolor"), [0 0 1])
+%!   assert (get (h, "linestyle"), "--")
+%!   assert (rows (get (h, "faces")), 16)
+%! unwind_protect_cleanup
+%!   close (hf);
+%! end_unwind_protect
+
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4);
+%! hf = figure ("visible", "off");
+%! unwind_protect
+%!   h = msh2p_mesh (mesh, "ko");
+%!   assert (get (h, "marker"), "o")
+%!   assert (get (h, "markeredgecolor"), [0 0 0])
+%!   assert (get (h, "linestyle"), "none")
+%!   h = msh2p_mesh (mesh, "-.x");
+%!   assert (get (h, "marker"), "x")
+%!   assert (get (h, "linestyle"), "-.")
+%! unwind_protect_cleanup
+%!   close (hf);
+%! end_unwind_protect
+
+%!error <unsupported character 'q'> msh2p_mesh (msh2m_structured_mesh (0:1, 0:1, 1, 1:4), "rq")
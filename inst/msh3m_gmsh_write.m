@@ -55,7 +55,7 @@ function msh3m_gmsh_write (filename, msh, node_data, cell_data)
 
     ## 4-node tetrahedra
     t = [[(number_of_tri+1):(number_of_tets+number_of_tri)]; ## element number
-         3*ones(1, number_of_tets);        ## element type, 3 = tetrahedron
+         4*ones(1, number_of_tets);        ## element type, 4 = tetrahedron
          3*ones(1, number_of_tets);        ## number of tags
          zeros(1, number_of_tets);         ## first tag, physical entity: 0 = unspecified
          msh.t(5, :);                      ## first tag, geometrical entity
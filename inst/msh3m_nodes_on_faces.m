@@ -26,7 +26,13 @@
 ## Return a list of @var{mesh} nodes lying on the faces specified in
 ## @var{facelist}.
 ##
-## @seealso{msh3m_geometrical_properties, msh2m_nodes_on_faces}
+## If @var{mesh} has a field @code{bindex} built by
+## @code{mshm_boundary_index}, the nodes are obtained by merging the
+## lists stored in it for each face, which is faster when the function
+## is called many times on the same mesh.
+##
+## @seealso{msh3m_geometrical_properties, msh2m_nodes_on_faces,
+## mshm_boundary_index}
 ## @end deftypefn
 
 function [nodelist] = msh3m_nodes_on_faces(mesh,facelist);
@@ -42,14 +48,7 @@ function [nodelist] = msh3m_nodes_on_faces(mesh,facelist);
   endif
 
   ## Search nodes
-  facefaces = [];
-  
-  for ii=1:length(facelist)
-    facefaces = [facefaces,find(mesh.e(10,:)==facelist(ii))];
-  endfor
-
-  facenodes = mesh.e(1:3,facefaces);
-  nodelist  = unique(facenodes(:));
+  nodelist = mshm_boundary_nodes(mesh,facelist);
   
 endfunction
 
@@ -67,4 +66,11 @@ endfunction
 % assert(nodelist,[1 3 5 7]')
 %!test
 % nodelist = msh3m_nodes_on_faces(mesh,[1 2 3]);
-% assert(nodelist,[1:8]')
\ No newline at end of file
+% assert(nodelist,[1:8]')
+%!test
+%! mesh = msh3m_structured_mesh(0:.5:1,0:.5:1,0:.5:1,1,1:6);
+%! nodelist = msh3m_nodes_on_faces(mesh,[1 2]);
+%! facenodes = mesh.e(1:3,ismember(mesh.e(10,:),[1 2]));
+%! assert(nodelist,unique(facenodes(:)));
+%! mesh.bindex = mshm_boundary_index(mesh);
+%! assert(msh3m_nodes_on_faces(mesh,[2 1]),nodelist);
@@ -70,7 +70,8 @@
 ## @end itemize 
 ##
 ## @seealso{msh2m_structured_mesh, msh3m_gmsh, msh2m_mesh_along_spline,
-## msh3m_join_structured_mesh, msh3m_submesh}
+## msh3m_join_structured_mesh, msh3m_submesh,
+## mshm_implicit_mesh}
 ## @end deftypefn
 
 function mesh = msh3m_structured_mesh (x, y, z, region, sides)
@@ -0,0 +1,112 @@
+## Copyright (C) 2026 Carlo de Falco
+##
+## This file is part of:
+##     MSH - Meshing Software Package for Octave
+##
+##  MSH is free software; you can redistribute it and/or modify
+##  it under the terms of the GNU General Public License as published by
+##  the Free Software Foundation; either version 2 of the License, or
+##  (at your option) any later version.
+##
+##  MSH is distributed in the hope that it will be useful,
+##  but WITHOUT ANY WARRANTY; without even the implied warranty of
+##  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+##  GNU General Public License for more details.
+##
+##  You should have received a copy of the GNU General Public License
+##  along with MSH; If not, see <http://www.gnu.org/licenses/>.
+##
+##  author: Carlo de Falco     <cdf _AT_ users.sourceforge.net>
+
+## -*- texinfo -*-
+## @deftypefn {Function File} {[@var{varargout}]} = @
+## msh3m_topological_properties(@var{mesh},[@var{string1},@var{string2},...])
+## 
+## Compute @var{mesh} topological properties identified by input strings.
+##
+## Valid properties are:
+## @itemize @bullet
+## @item @code{"v2c"}: return a structure with the fields @code{ptr}
+## and @code{idx} in compressed sparse row form: the elements containing
+## node @code{i} are @code{idx(ptr(i):ptr(i+1)-1)}.
+## @item @code{"v2v"}: return a structure in the same form containing
+## the nodes connected by an edge to each node.
+## @item @code{"c2c"}: return a structure in the same form containing
+## the elements sharing a face with each element, in the order of the
+## faces opposite to the first, second, third and fourth vertex.
+## @item @code{"pattern"}: return the sparsity pattern of the matrices
+## assembled on the mesh with linear elements.
+## @end itemize
+##
+## The output will contain the topological properties requested in the
+## input in the same order specified in the function call.
+##
+## If an unexpected string is given as input, an empty vector is
+## returned in output.
+##
+## @seealso{msh2m_topological_properties, msh3m_geometrical_properties,
+## mshm_adjacency}
+## @end deftypefn
+
+function [varargout] = msh3m_topological_properties (imesh,varargin)
+
+  ## Check input
+  if (nargin < 2) # Number of input parameters
+    error ("msh3m_topological_properties: wrong number of input parameters.");
+  elseif (! (isstruct (imesh) && isfield (imesh,"p") &&
+     isfield (imesh,"t") && isfield (imesh,"e")))
+    error ("msh3m_topological_properties: first input is not a valid mesh structure.");
+  elseif (! iscellstr (varargin))
+    error ("msh3m_topological_properties: only string value admitted for properties.");
+  endif
+
+  ## Compute properties
+  for nn = 1:length (varargin)
+    
+    request = varargin{nn};
+    
+    switch request
+
+      case {"v2c", "v2v", "c2c", "pattern"} # CSR adjacency
+        if isfield (imesh,request)
+          varargout{nn} = imesh.(request);
+        else
+          varargout{nn} = mshm_adjacency (imesh,request);
+        endif
+
+      otherwise
+        warning ("msh3m_topological_properties: unexpected value in property string. Empty vector passed as output.")
+        varargout{nn} = [];
+        
+    endswitch
+    
+  endfor
+
+endfunction
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! [v2c, c2c] = msh3m_topological_properties (mesh, "v2c", "c2c");
+%! t = mesh.t(1:4,:);
+%! for inode = 1:columns (mesh.p)
+%!   assert (v2c.idx(v2c.ptr(inode):v2c.ptr(inode+1)-1), find (any (t == inode))')
+%! endfor
+%! for iel = 1:columns (t)
+%!   nb = c2c.idx(c2c.ptr(iel):c2c.ptr(iel+1)-1);
+%!   assert (sum (ismember (t(:,nb), t(:,iel))), 3 * ones (1, numel (nb)))
+%! endfor
+%! assert (numel (c2c.idx) + columns (mesh.e), 4 * columns (t))
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! [v2v, pattern] = msh3m_topological_properties (mesh, "v2v", "pattern");
+%! [ii, jj] = find (pattern);
+%! assert (jj, repelems (1:columns (mesh.p), [1:columns(mesh.p); diff(v2v.ptr)'+1])')
+%! assert (pattern, pattern')
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! mesh.v2v = "cached";
+%! assert (msh3m_topological_properties (mesh, "v2v"), "cached")
+%! warning ("off", "all", "local");
+%! assert (msh3m_topological_properties (mesh, "foo"), [])
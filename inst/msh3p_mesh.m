@@ -0,0 +1,87 @@
+## Copyright (C) 2026 Carlo de Falco
+##
+## This file is part of:
+##     MSH - Meshing Software Package for Octave
+##
+##  MSH is free software; you can redistribute it and/or modify
+##  it under the terms of the GNU General Public License as published by
+##  the Free Software Foundation; either version 2 of the License, or
+##  (at your option) any later version.
+##
+##  MSH is distributed in the hope that it will be useful,
+##  but WITHOUT ANY WARRANTY; without even the implied warranty of
+##  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+##  GNU General Public License for more details.
+##
+##  You should have received a copy of the GNU General Public License
+##  along with MSH; If not, see <http://www.gnu.org/licenses/>.
+##
+##  author: Carlo de Falco     <cdf _AT_ users.sourceforge.net>
+
+## -*- texinfo -*-
+## @deftypefn {Function File} {} msh3p_mesh (@var{mesh})
+## @deftypefnx {Function File} {} msh3p_mesh (@var{mesh}, @var{labels})
+## @deftypefnx {Function File} {} msh3p_mesh (@var{mesh}, @var{labels}, @
+## @var{property}, @var{value}, @dots{})
+## @deftypefnx {Function File} {@var{h}} = msh3p_mesh (@dots{})
+##
+## Plot the faces in the field e of the 3D mesh @var{mesh} whose face
+## numbers are in @var{labels} (default all), colored by face number.
+##
+## The faces are drawn in a single patch object whose handle is
+## returned in @var{h}, so that very large meshes can be inspected
+## interactively.  Their edges are not drawn if there are more than
+## 1e5 faces.  The optional @var{property} and @var{value} pairs are
+## passed to @code{patch}, and override these defaults.
+##
+## @seealso{mshm_plot_data, msh2p_mesh, msh3e_surface_mesh}
+##
+## @end deftypefn
+
+function h = msh3p_mesh (mesh, labels, varargin)
+
+  ## Check input
+  if (nargin < 1 || (nargin > 2 && mod (nargin, 2) != 0))
+    error ("msh3p_mesh: wrong number of input parameters.");
+  elseif (! (isstruct (mesh) && isfield (mesh, "p") &&
+             isfield (mesh, "t") && isfield (mesh, "e")))
+    error ("msh3p_mesh: first input is not a valid mesh structure.");
+  elseif (rows (mesh.p) != 3)
+    error ("msh3p_mesh: only 3D meshes can be plotted.");
+  endif
+
+  if (nargin < 2 || isempty (labels))
+    [vertices, faces, color] = mshm_plot_data (mesh);
+  else
+    [vertices, faces, color] = mshm_plot_data (mesh, "labels", labels);
+  endif
+
+  edgecolor = "k";
+  if (rows (faces) > 1e5)
+    edgecolor = "none";
+  endif
+
+  hh = patch ("Faces", faces, "Vertices", vertices,
+              "FaceVertexCData", color, "FaceColor", "flat",
+              "EdgeColor", edgecolor, varargin{:});
+  if (! ishold ())
+    view (3);
+  endif
+  if (nargout > 0)
+    h = hh;
+  endif
+
+endfunction
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! hf = figure ("visible", "off");
+%! unwind_protect
+%!   h = msh3p_mesh (mesh, [1 2], "FaceAlpha", .5);
+%!   assert (get (h, "type"), "patch")
+%!   assert (rows (get (h, "faces")), 16)
+%!   assert (unique (get (h, "facevertexcdata"))', [1 2])
+%!   assert (get (h, "facealpha"), .5)
+%! unwind_protect_cleanup
+%!   close (hf);
+%! end_unwind_protect
@@ -0,0 +1,726 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Binary mesh checkpoints.
+//
+// A checkpoint holds a number of named sections, each a column-major
+// double matrix (the fields p, e and t of a mesh).  The columns of a
+// section are stored in blocks of a fixed number of columns, and each
+// block is encoded row by row:
+//
+//  - rows of integers (node numbers, tags) are stored as the
+//    differences between consecutive columns, zigzag and varint
+//    encoded, so that connectivity numbered with some locality takes
+//    one or two bytes per entry;
+//  - rows of coordinates are stored as the exclusive or of the bits of
+//    consecutive values, with the bytes of each value split in eight
+//    planes, which is lossless and compresses well; they may instead
+//    be stored as the nearest multiple of a given step, as an integer,
+//    and the exclusive or of their bits with those of that multiple,
+//    which is still lossless and takes a few bytes for coordinates on
+//    or near such a grid.
+//
+// Each block is then compressed with zlib, when available.  Blocks are
+// encoded and decoded independently and in parallel, and the index at
+// the end of the file gives the position of each of them, so that a
+// range of columns can be read without decoding the rest.  All the
+// numbers in the index are little endian.
+//
+// File layout: the magic string "MSHCKPT1", the blocks, the index and a
+// 24 bytes trailer with the position and size of the index followed by
+// the magic string "MSHCKIDX".
+
+#if ! defined (MSH_CHECKPOINT_H)
+#define MSH_CHECKPOINT_H 1
+
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined (HAVE_ZLIB_H)
+#  include <zlib.h>
+#endif
+
+#include "msh_kernels.h"
+
+namespace msh
+{
+  namespace checkpoint
+  {
+    typedef std::vector<unsigned char> bytes;
+
+    static const char file_magic[] = "MSHCKPT1";
+    static const char index_magic[] = "MSHCKIDX";
+    static const std::uint64_t trailer_size = 24;
+
+    // Columns per block.
+    static const std::uint64_t block_cols = 1 << 16;
+
+    enum row_coding { coding_integer = 0, coding_float = 1,
+                      coding_quantized = 2 };
+
+    enum block_method { method_raw = 0, method_zlib = 1 };
+
+    struct row_info
+    {
+      unsigned char coding;
+      double origin, step;     // for coding_quantized only
+
+      row_info (void) : coding (coding_float), origin (0), step (0) { }
+    };
+
+    struct block_info
+    {
+      std::uint64_t offset, size, raw_size;
+      unsigned char method;
+    };
+
+    struct section
+    {
+      std::string name;
+      std::uint64_t rows, cols, block_cols;
+      std::vector<row_info> row;
+      std::vector<block_info> block;
+
+      section (void) : name (), rows (0), cols (0), block_cols (0),
+                       row (), block () { }
+    };
+
+    inline void
+    put_varint (bytes& out, std::uint64_t v)
+    {
+      while (v >= 0x80)
+        {
+          out.push_back (static_cast<unsigned char> (v | 0x80));
+          v >>= 7;
+        }
+      out.push_back (static_cast<unsigned char> (v));
+    }
+
+    inline bool
+    get_varint (const unsigned char *& in, const unsigned char *end,
+                std::uint64_t& v)
+    {
+      v = 0;
+      for (int shift = 0; in < end && shift < 64; shift += 7)
+        {
+          const unsigned char c = *in++;
+          v |= std::uint64_t (c & 0x7f) << shift;
+          if (! (c & 0x80))
+            return true;
+        }
+      return false;
+    }
+
+    inline std::uint64_t
+    zigzag (std::int64_t v)
+    {
+      return (std::uint64_t (v) << 1) ^ std::uint64_t (v >> 63);
+    }
+
+    inline std::int64_t
+    unzigzag (std::uint64_t v)
+    {
+      return std::int64_t (v >> 1) ^ -std::int64_t (v & 1);
+    }
+
+    // k - prev, wrapping around instead of overflowing; the decoder
+    // adds the deltas back in the same way, so that corrupt data
+    // cannot cause signed overflow.
+    inline std::int64_t
+    delta (std::int64_t k, std::int64_t prev)
+    {
+      return std::int64_t (std::uint64_t (k) - std::uint64_t (prev));
+    }
+
+    inline void
+    put_u64 (bytes& out, std::uint64_t v)
+    {
+      for (int b = 0; b < 8; ++b)
+        out.push_back (static_cast<unsigned char> (v >> (8 * b)));
+    }
+
+    inline std::uint64_t
+    get_u64 (const unsigned char *in)
+    {
+      std::uint64_t v = 0;
+      for (int b = 7; b >= 0; --b)
+        v = (v << 8) | in[b];
+      return v;
+    }
+
+    inline std::uint64_t
+    double_bits (double x)
+    {
+      std::uint64_t v;
+      std::memcpy (&v, &x, sizeof (v));
+      return v;
+    }
+
+    inline double
+    bits_double (std::uint64_t v)
+    {
+      double x;
+      std::memcpy (&x, &v, sizeof (x));
+      return x;
+    }
+
+    // True if x is stored exactly by coding_integer (-0 is not).
+    inline bool
+    is_integer (double x)
+    {
+      return x == std::floor (x) && std::abs (x) < 9007199254740992.0
+        && ! (x == 0 && std::signbit (x));
+    }
+
+    // Choose the coding of row r of the rows x cols matrix a: integers
+    // if all the entries are, otherwise multiples of step if it is
+    // positive (and the entries are finite and span less than 2^52
+    // steps), otherwise their bits.  std::min and std::max skip NaN,
+    // so the entries are tested for being finite on their own.
+    inline row_info
+    choose_coding (const double *a, std::uint64_t rows, std::uint64_t cols,
+                   std::uint64_t r, double step)
+    {
+      bool integer = true, finite = true;
+      double lo = HUGE_VAL, hi = -HUGE_VAL;
+#pragma omp parallel for reduction(&&:integer, finite) reduction(min:lo) \
+  reduction(max:hi)
+      for (index_t j = 0; j < index_t (cols); ++j)
+        {
+          const double x = a[r + rows * j];
+          integer = integer && is_integer (x);
+          finite = finite && ! std::isnan (x) && ! std::isinf (x);
+          lo = std::min (lo, x);
+          hi = std::max (hi, x);
+        }
+
+      row_info ri;
+      if (integer)
+        ri.coding = coding_integer;
+      else if (step > 0 && finite && (hi - lo) / step < 4503599627370496.0)
+        {
+          ri.coding = coding_quantized;
+          ri.origin = lo;
+          ri.step = step;
+        }
+      return ri;
+    }
+
+    // Grid point k of a quantized row.  fma rounds only once, so the
+    // result does not depend on how the compiler contracts floating
+    // point expressions and the encoder and decoder agree bit for bit.
+    inline double
+    grid_value (const row_info& ri, std::int64_t k)
+    {
+      return std::fma (double (k), ri.step, ri.origin);
+    }
+
+    // Append the encoding of columns c0 ... c1-1 of a to out.
+    inline void
+    encode_block (const double *a, std::uint64_t rows,
+                  const std::vector<row_info>& info,
+                  std::uint64_t c0, std::uint64_t c1, bytes& out)
+    {
+      const std::uint64_t n = c1 - c0;
+      for (std::uint64_t r = 0; r < rows; ++r)
+        {
+          const double *x = a + r + rows * c0;
+          if (info[r].coding == coding_float)
+            {
+              const std::size_t base = out.size ();
+              out.resize (base + 8 * n);
+              unsigned char *plane = &out[base];
+              std::uint64_t prev = 0;
+              for (std::uint64_t j = 0; j < n; ++j)
+                {
+                  const std::uint64_t v = double_bits (x[rows * j]);
+                  const std::uint64_t d = v ^ prev;
+                  prev = v;
+                  for (int b = 0; b < 8; ++b)
+                    plane[b * n + j]
+                      = static_cast<unsigned char> (d >> (8 * b));
+                }
+            }
+          else if (info[r].coding == coding_quantized)
+            {
+              std::int64_t prev = 0;
+              for (std::uint64_t j = 0; j < n; ++j)
+                {
+                  const double v = x[rows * j];
+                  const std::int64_t k
+                    = std::llround ((v - info[r].origin) / info[r].step);
+                  put_varint (out, zigzag (delta (k, prev)));
+                  put_varint (out, double_bits (v)
+                                   ^ double_bits (grid_value (info[r], k)));
+                  prev = k;
+                }
+            }
+          else
+            {
+              std::int64_t prev = 0;
+              for (std::uint64_t j = 0; j < n; ++j)
+                {
+                  const std::int64_t k = std::int64_t (x[rows * j]);
+                  put_varint (out, zigzag (delta (k, prev)));
+                  prev = k;
+                }
+            }
+        }
+    }
+
+    // Decode n columns into the rows x n matrix out.  Return false if
+    // the data are corrupt.
+    inline bool
+    decode_block (const unsigned char *in, std::uint64_t size,
+                  std::uint64_t rows, const std::vector<row_info>& info,
+                  std::uint64_t n, double *out)
+    {
+      const unsigned char *end = in + size;
+      for (std::uint64_t r = 0; r < rows; ++r)
+        {
+          double *x = out + r;
+          if (info[r].coding == coding_float)
+            {
+              if (std::uint64_t (end - in) < 8 * n)
+                return false;
+              std::uint64_t prev = 0;
+              for (std::uint64_t j = 0; j < n; ++j)
+                {
+                  std::uint64_t d = 0;
+                  for (int b = 7; b >= 0; --b)
+                    d = (d << 8) | in[b * n + j];
+                  prev ^= d;
+                  x[rows * j] = bits_double (prev);
+                }
+              in += 8 * n;
+            }
+          else
+            {
+              const bool q = info[r].coding == coding_quantized;
+              std::int64_t k = 0;
+              for (std::uint64_t j = 0; j < n; ++j)
+                {
+                  std::uint64_t v, resid = 0;
+                  if (! get_varint (in, end, v)
+                      || (q && ! get_varint (in, end, resid)))
+                    return false;
+                  k = std::int64_t (std::uint64_t (k)
+                                    + std::uint64_t (unzigzag (v)));
+                  x[rows * j]
+                    = q ? bits_double (double_bits (grid_value (info[r], k))
+                                       ^ resid)
+                        : double (k);
+                }
+            }
+        }
+      return in == end;
+    }
+
+    // Compress raw into out, unless zlib is not available or does not
+    // make it smaller; return the method used.
+    inline unsigned char
+    compress_block (const bytes& raw, bytes& out, int level)
+    {
+#if defined (HAVE_ZLIB_H)
+      if (level > 0 && ! raw.empty ())
+        {
+          uLongf len = compressBound (raw.size ());
+          out.resize (len);
+          if (compress2 (&out[0], &len, &raw[0], raw.size (), level) == Z_OK
+              && len < raw.size ())
+            {
+              out.resize (len);
+              return method_zlib;
+            }
+        }
+#else
+      (void) level;
+#endif
+      out = raw;
+      return method_raw;
+    }
+
+    // Decompress block b into raw, which has room for its raw_size
+    // bytes.  Return false if the data are corrupt.
+    inline bool
+    decompress_block (const unsigned char *in, const block_info& b,
+                      unsigned char *raw)
+    {
+      if (b.method == method_raw)
+        {
+          if (b.size != b.raw_size)
+            return false;
+          std::copy (in, in + b.size, raw);
+          return true;
+        }
+#if defined (HAVE_ZLIB_H)
+      if (b.method == method_zlib && uLongf (b.raw_size) == b.raw_size)
+        {
+          uLongf len = b.raw_size;
+          return uncompress (raw, &len, in, b.size) == Z_OK
+            && len == b.raw_size;
+        }
+#endif
+      return false;
+    }
+
+    inline void
+    put_index (bytes& out, const std::vector<section>& sec)
+    {
+      put_u64 (out, sec.size ());
+      for (std::size_t s = 0; s < sec.size (); ++s)
+        {
+          put_u64 (out, sec[s].name.size ());
+          out.insert (out.end (), sec[s].name.begin (), sec[s].name.end ());
+          put_u64 (out, sec[s].rows);
+          put_u64 (out, sec[s].cols);
+          put_u64 (out, sec[s].block_cols);
+          for (std::uint64_t r = 0; r < sec[s].rows; ++r)
+            {
+              out.push_back (sec[s].row[r].coding);
+              put_u64 (out, double_bits (sec[s].row[r].origin));
+              put_u64 (out, double_bits (sec[s].row[r].step));
+            }
+          put_u64 (out, sec[s].block.size ());
+          for (std::size_t b = 0; b < sec[s].block.size (); ++b)
+            {
+              put_u64 (out, sec[s].block[b].offset);
+              put_u64 (out, sec[s].block[b].size);
+              put_u64 (out, sec[s].block[b].raw_size);
+              out.push_back (sec[s].block[b].method);
+            }
+        }
+    }
+
+    // Parse the index; return false if it is corrupt.
+    inline bool
+    get_index (const bytes& in, std::vector<section>& sec)
+    {
+      const unsigned char *p = in.empty () ? 0 : &in[0];
+      const unsigned char *end = p + in.size ();
+      if (end - p < 8)
+        return false;
+      const std::uint64_t ns = get_u64 (p);
+      p += 8;
+      if (ns > in.size ())
+        return false;
+      sec.assign (ns, section ());
+      for (std::size_t s = 0; s < sec.size (); ++s)
+        {
+          if (end - p < 8)
+            return false;
+          const std::uint64_t len = get_u64 (p);
+          p += 8;
+          if (std::uint64_t (end - p) < 24
+              || len > std::uint64_t (end - p) - 24)
+            return false;
+          sec[s].name.assign (reinterpret_cast<const char *> (p), len);
+          p += len;
+          sec[s].rows = get_u64 (p);
+          sec[s].cols = get_u64 (p + 8);
+          sec[s].block_cols = get_u64 (p + 16);
+          p += 24;
+          if (sec[s].rows > std::uint64_t (end - p) / 17)
+            return false;
+          sec[s].row.resize (sec[s].rows);
+          for (std::uint64_t r = 0; r < sec[s].rows; ++r)
+            {
+              sec[s].row[r].coding = p[0];
+              sec[s].row[r].origin = bits_double (get_u64 (p + 1));
+              sec[s].row[r].step = bits_double (get_u64 (p + 9));
+              if (p[0] > coding_quantized)
+                return false;
+              p += 17;
+            }
+          if (end - p < 8)
+            return false;
+          const std::uint64_t nb = get_u64 (p);
+          p += 8;
+          if (nb > std::uint64_t (end - p) / 25)
+            return false;
+          const std::uint64_t bc = sec[s].block_cols;
+          if (bc == 0 ? sec[s].cols != 0 || nb != 0
+                      : nb != (sec[s].cols + bc - 1) / bc)
+            return false;
+          sec[s].block.resize (nb);
+          for (std::uint64_t b = 0; b < nb; ++b)
+            {
+              sec[s].block[b].offset = get_u64 (p);
+              sec[s].block[b].size = get_u64 (p + 8);
+              sec[s].block[b].raw_size = get_u64 (p + 16);
+              sec[s].block[b].method = p[24];
+              p += 25;
+            }
+        }
+      return p == end;
+    }
+
+    // Sequential writer of a checkpoint file.
+    class writer
+    {
+    public:
+
+      writer (void) : m_fp (0), m_ok (false), m_level (1), m_sec () { }
+
+      ~writer (void) { if (m_fp) std::fclose (m_fp); }
+
+      bool
+      open (const std::string& name, int level)
+      {
+        m_level = level;
+        m_fp = std::fopen (name.c_str (), "wb");
+        m_ok = m_fp && std::fwrite (file_magic, 1, 8, m_fp) == 8;
+        return m_ok;
+      }
+
+      // Append the rows x cols matrix a as section name.  Coordinates
+      // that are not integers are stored as multiples of step if it is
+      // positive.  The blocks are encoded and compressed in parallel,
+      // a few per thread at a time, and written in order.
+      void
+      add (const std::string& name, const double *a, std::uint64_t rows,
+           std::uint64_t cols, double step = 0)
+      {
+        section s;
+        s.name = name;
+        s.rows = rows;
+        s.cols = cols;
+        s.block_cols = cols > 0 ? block_cols : 0;
+        for (std::uint64_t r = 0; r < rows; ++r)
+          s.row.push_back (choose_coding (a, rows, cols, r, step));
+
+        const std::uint64_t nb
+          = s.block_cols ? (cols + s.block_cols - 1) / s.block_cols : 0;
+        const std::uint64_t wave = 4 * num_threads ();
+        std::vector<bytes> out (std::min (nb, wave));
+        s.block.resize (nb);
+        for (std::uint64_t b0 = 0; b0 < nb && m_ok; b0 += wave)
+          {
+            const index_t b1 = std::min (nb, b0 + wave);
+#pragma omp parallel for schedule(dynamic)
+            for (index_t b = b0; b < b1; ++b)
+              {
+                bytes raw;
+                const std::uint64_t c0 = b * s.block_cols;
+                encode_block (a, rows, s.row, c0,
+                              std::min (cols, c0 + s.block_cols), raw);
+                s.block[b].raw_size = raw.size ();
+                s.block[b].method = compress_block (raw, out[b - b0],
+                                                    m_level);
+                s.block[b].size = out[b - b0].size ();
+              }
+            for (index_t b = b0; b < b1 && m_ok; ++b)
+              {
+                s.block[b].offset = ftello (m_fp);
+                m_ok = out[b - b0].empty ()
+                  || std::fwrite (&out[b - b0][0], 1, out[b - b0].size (),
+                                  m_fp) == out[b - b0].size ();
+              }
+          }
+        m_sec.push_back (s);
+      }
+
+      // Write the index and close the file; return false if anything
+      // could not be written.
+      bool
+      close (void)
+      {
+        if (! m_fp)
+          return false;
+        bytes idx;
+        put_index (idx, m_sec);
+        const std::uint64_t pos = ftello (m_fp);
+        put_u64 (idx, pos);
+        put_u64 (idx, idx.size () - 8);
+        idx.insert (idx.end (), index_magic, index_magic + 8);
+        m_ok = m_ok && std::fwrite (&idx[0], 1, idx.size (), m_fp)
+          == idx.size ();
+        m_ok = std::fclose (m_fp) == 0 && m_ok;
+        m_fp = 0;
+        return m_ok;
+      }
+
+    private:
+
+      writer (const writer&);
+      writer& operator = (const writer&);
+
+      std::FILE *m_fp;
+      bool m_ok;
+      int m_level;
+      std::vector<section> m_sec;
+    };
+
+    // Random access reader of a checkpoint file.
+    class reader
+    {
+    public:
+
+      reader (void) : m_fp (0), m_sec () { }
+
+      ~reader (void) { if (m_fp) std::fclose (m_fp); }
+
+      // Open name and read its index; return false if it is not a
+      // checkpoint file.
+      bool
+      open (const std::string& name)
+      {
+        m_fp = std::fopen (name.c_str (), "rb");
+        if (! m_fp)
+          return false;
+        unsigned char head[8], tail[trailer_size];
+        if (std::fread (head, 1, 8, m_fp) != 8
+            || std::memcmp (head, file_magic, 8) != 0
+            || fseeko (m_fp, -off_t (trailer_size), SEEK_END) != 0)
+          return false;
+        const std::uint64_t end = ftello (m_fp);
+        if (std::fread (tail, 1, trailer_size, m_fp) != trailer_size
+            || std::memcmp (tail + 16, index_magic, 8) != 0)
+          return false;
+        const std::uint64_t pos = get_u64 (tail), size = get_u64 (tail + 8);
+        if (pos < 8 || size > end || pos != end - size)
+          return false;
+        bytes idx (size);
+        if (fseeko (m_fp, off_t (pos), SEEK_SET) != 0
+            || (size && std::fread (&idx[0], 1, size, m_fp) != size)
+            || ! get_index (idx, m_sec))
+          return false;
+        // An entry takes at most 20 bytes once decompressed (two
+        // varints), which bounds the buffers allocated by read.
+        for (std::size_t s = 0; s < m_sec.size (); ++s)
+          {
+            const section& sc = m_sec[s];
+            if (sc.block_cols > block_cols)
+              return false;
+            for (std::size_t b = 0; b < sc.block.size (); ++b)
+              {
+                const block_info& bi = sc.block[b];
+                const std::uint64_t first = b * sc.block_cols;
+                const std::uint64_t n
+                  = std::min (sc.cols, first + sc.block_cols) - first;
+                if (bi.offset < 8 || bi.offset > pos
+                    || bi.size > pos - bi.offset
+                    || (b > 0 && bi.offset != sc.block[b-1].offset
+                                              + sc.block[b-1].size)
+                    || bi.method > method_zlib
+                    || (bi.method == method_raw && bi.size != bi.raw_size)
+                    || sc.rows > UINT64_MAX / (20 * n)
+                    || bi.raw_size > 20 * n * sc.rows)
+                  return false;
+              }
+          }
+        return true;
+      }
+
+      const std::vector<section>& sections (void) const { return m_sec; }
+
+      // The section called name, or 0.
+      const section *
+      find (const std::string& name) const
+      {
+        for (std::size_t s = 0; s < m_sec.size (); ++s)
+          if (m_sec[s].name == name)
+            return &m_sec[s];
+        return 0;
+      }
+
+      // Read columns c0 ... c1-1 of s into the rows x (c1-c0) matrix out,
+      // with a single read of the blocks holding them, which are then
+      // decoded in parallel, a few per thread at a time.  The buffers
+      // of each wave are allocated beforehand, so that nothing in the
+      // parallel loop can throw.  Return false on error.
+      bool
+      read (const section& s, std::uint64_t c0, std::uint64_t c1,
+            double *out)
+      {
+        if (c0 >= c1)
+          return c0 == c1 && c1 <= s.cols;
+        if (c1 > s.cols)
+          return false;
+        const std::uint64_t bc = s.block_cols;
+        const index_t b0 = c0 / bc, b1 = (c1 - 1) / bc + 1;
+        const std::uint64_t base = s.block[b0].offset;
+        bytes buf (s.block[b1-1].offset + s.block[b1-1].size - base);
+        if (fseeko (m_fp, off_t (base), SEEK_SET) != 0
+            || (! buf.empty ()
+                && std::fread (&buf[0], 1, buf.size (), m_fp) != buf.size ()))
+          return false;
+
+        const index_t wave = 4 * num_threads ();
+        std::vector<bytes> raw (std::min (b1 - b0, wave));
+        std::vector<double> head, tail;
+        bool ok = true;
+        for (index_t w0 = b0; w0 < b1 && ok; w0 += wave)
+          {
+            const index_t w1 = std::min (b1, w0 + wave);
+            for (index_t b = w0; b < w1; ++b)
+              raw[b - w0].resize (s.block[b].raw_size);
+            // Only the first and last blocks can be partly wanted.
+            if (w0 == b0 && c0 % bc != 0)
+              head.resize (s.rows * bc);
+            if (w1 == b1 && c1 % bc != 0 && c1 != s.cols)
+              tail.resize (s.rows * bc);
+
+#pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+            for (index_t b = w0; b < w1; ++b)
+              {
+                const std::uint64_t first = b * bc;
+                const std::uint64_t n = std::min (s.cols, first + bc) - first;
+                const std::uint64_t j0 = std::max (first, c0);
+                const std::uint64_t j1 = std::min (first + n, c1);
+                const bool whole = j0 == first && j1 == first + n;
+                double *dst = out + s.rows * (j0 - c0);
+                if (! whole)
+                  dst = b == b0 && ! head.empty () ? &head[0] : &tail[0];
+                unsigned char *r = raw[b - w0].empty () ? 0 : &raw[b - w0][0];
+                bool good
+                  = decompress_block (buf.empty () ? 0
+                                      : &buf[s.block[b].offset - base],
+                                      s.block[b], r)
+                  && decode_block (r, raw[b - w0].size (), s.rows, s.row, n,
+                                   dst);
+                if (good && ! whole)
+                  std::copy (dst + s.rows * (j0 - first),
+                             dst + s.rows * (j1 - first),
+                             out + s.rows * (j0 - c0));
+                ok = ok && good;
+              }
+          }
+        return ok;
+      }
+
+    private:
+
+      reader (const reader&);
+      reader& operator = (const reader&);
+
+      std::FILE *m_fp;
+      std::vector<section> m_sec;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,1521 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Mesh kernels shared by the compiled functions of the msh package.
+//
+// Nothing in this file depends on Octave: the kernels work on plain
+// column-major buffers laid out exactly as the fields of a PDE-tool
+// like mesh (p, e, t), so that the oct-files can hand them the data
+// of Octave arrays without copying and run them from worker threads.
+// Connectivity stored in the buffers is 1-based, as in Octave.
+
+#if ! defined (MSH_KERNELS_H)
+#define MSH_KERNELS_H 1
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined (_OPENMP)
+#include <omp.h>
+#endif
+
+namespace msh
+{
+  typedef std::ptrdiff_t index_t;
+
+  // Number of worker threads used by the parallel kernels.
+  inline int
+  num_threads ()
+  {
+#if defined (_OPENMP)
+    return omp_get_max_threads ();
+#else
+    return 1;
+#endif
+  }
+
+  // Read-only access to a row of tags (region or side numbers), which
+  // are either stored as doubles among the rows of t and e or, in the
+  // compact representation, in separate int16 or int32 arrays.
+  struct tag_row
+  {
+    enum tag_type { none, f64, i32, i16 };
+
+    tag_type type;
+    const void *data;
+    index_t stride;
+
+    tag_row (void) : type (none), data (0), stride (0) { }
+
+    tag_row (const double *d, index_t s) : type (f64), data (d), stride (s) { }
+
+    tag_row (const int32_t *d, index_t s) : type (i32), data (d), stride (s) { }
+
+    tag_row (const int16_t *d, index_t s) : type (i16), data (d), stride (s) { }
+
+    double
+    operator () (index_t j) const
+    {
+      switch (type)
+        {
+        case f64:
+          return static_cast<const double *> (data)[stride * j];
+        case i32:
+          return static_cast<const int32_t *> (data)[stride * j];
+        case i16:
+          return static_cast<const int16_t *> (data)[stride * j];
+        default:
+          return 0;
+        }
+    }
+  };
+
+  // Largest number of rows of e holding nodes or tags in the PDE-tool
+  // layout (10 for 3D meshes).
+  static const int max_erows = 10;
+
+  // Read-only view of a PDE-tool like mesh.  Each field is a
+  // column-major matrix with the given number of rows; T is the
+  // storage type of the connectivity fields.  The region of each
+  // element and the rows of e are read through treg and etag, so that
+  // the same view describes both the usual layout, where they are
+  // rows of t and e, and the compact one, where t and e only hold
+  // node numbers.
+  template <typename T>
+  struct mesh_view
+  {
+    int dim;              // space dimension, 2 or 3
+    index_t np, ne, nt;   // number of points, boundary facets, elements
+    const double *p;      // dim x np
+    const T *e;           // erows x ne
+    const T *t;           // trows x nt
+    index_t erows, trows;
+    tag_row treg;               // region of each element
+    tag_row etag[max_erows];    // rows dim+1 ... of e, by row number
+
+    // 0-based index of vertex k of element j.
+    index_t tv (int k, index_t j) const
+    { return static_cast<index_t> (t[k + trows * j]) - 1; }
+
+    // 0-based index of vertex k of boundary facet j.
+    index_t ev (int k, index_t j) const
+    { return static_cast<index_t> (e[k + erows * j]) - 1; }
+
+    // Region number of element j.
+    double region (index_t j) const { return treg (j); }
+
+    // Entry in row r (0-based, r < max_erows) of column j of e, as it
+    // would be in the usual layout.
+    double elabel (int r, index_t j) const { return etag[r] (j); }
+
+    const double *point (index_t i) const { return p + dim * i; }
+
+    // Point treg and etag at the rows of t and e, for the usual layout
+    // with tags stored among the connectivity.
+    void
+    set_inline_tags (void)
+    {
+      treg = tag_row (t + dim + 1, trows);
+      for (int r = 0; r < max_erows; ++r)
+        etag[r] = r < erows ? tag_row (e + r, erows) : tag_row ();
+    }
+  };
+
+  // Sizes of the structured meshes built by msh2m_structured_mesh and
+  // msh3m_structured_mesh.
+  struct structured_size
+  {
+    index_t np, ne, nt;
+  };
+
+  inline structured_size
+  structured_mesh_size (index_t nx, index_t ny)
+  {
+    structured_size s;
+    s.np = nx * ny;
+    s.nt = 2 * (nx - 1) * (ny - 1);
+    s.ne = 2 * (nx - 1) + 2 * (ny - 1);
+    return s;
+  }
+
+  inline structured_size
+  structured_mesh_size (index_t nx, index_t ny, index_t nz)
+  {
+    structured_size s;
+    s.np = nx * ny * nz;
+    s.nt = 6 * (nx - 1) * (ny - 1) * (nz - 1);
+    s.ne = 4 * ((nx - 1) * (ny - 1) + (ny - 1) * (nz - 1)
+                + (nx - 1) * (nz - 1));
+    return s;
+  }
+
+  // Fill p (2 x np), e (7 x ne) and t (4 x nt) with the mesh built by
+  // msh2m_structured_mesh.  The nodes, elements and side edges are
+  // numbered exactly as in the m-file; x and y must be sorted.
+  inline void
+  structured_mesh_2d (const double *x, index_t nx,
+                      const double *y, index_t ny,
+                      double region, const double *sides, bool left,
+                      double *p, double *e, double *t)
+  {
+    for (index_t ix = 0, k = 0; ix < nx; ++ix)
+      for (index_t iy = 0; iy < ny; ++iy, ++k)
+        {
+          p[2*k]   = x[ix];
+          p[2*k+1] = y[iy];
+        }
+
+    const index_t nc = (nx - 1) * (ny - 1);
+    for (index_t ix = 0, c = 0; ix < nx - 1; ++ix)
+      for (index_t iy = 0; iy < ny - 1; ++iy, ++c)
+        {
+          const double n = iy + ny * ix + 1;
+          double *t1 = t + 4 * c;
+          double *t2 = t + 4 * (c + nc);
+          if (left)
+            {
+              t1[0] = n;     t1[1] = n + ny; t1[2] = n + 1;
+              t2[0] = n + 1; t2[1] = n + ny; t2[2] = n + ny + 1;
+            }
+          else
+            {
+              t1[0] = n;     t1[1] = n + ny;     t1[2] = n + ny + 1;
+              t2[0] = n;     t2[1] = n + ny + 1; t2[2] = n + 1;
+            }
+          t1[3] = t2[3] = region;
+        }
+
+    // Sides are listed bottom, right, top, left, each one with
+    // increasing node numbers.
+    const index_t first[4] = {1, ny * (nx - 1) + 1, ny, 1};
+    const index_t step[4]  = {ny, 1, ny, 1};
+    const index_t count[4] = {nx - 1, ny - 1, nx - 1, ny - 1};
+    for (int s = 0, j = 0; s < 4; ++s)
+      for (index_t k = 0; k < count[s]; ++k, ++j)
+        {
+          double *ej = e + 7 * j;
+          ej[0] = first[s] + k * step[s];
+          ej[1] = ej[0] + step[s];
+          ej[2] = ej[3] = ej[5] = 0;
+          ej[4] = sides[s];
+          ej[6] = region;
+        }
+  }
+
+  // Local vertex offsets (in units of the node numbering strides
+  // 1, ny and nx*ny) of the six tetrahedra that msh3m_structured_mesh
+  // places in each hexahedral cell, listed as (di, dj, dk) where i, j, k
+  // run along x, y and z.
+  static const int kuhn_offsets[6][4][3] =
+    {{{0,0,0}, {1,0,0}, {0,1,0}, {0,1,1}},
+     {{0,0,1}, {0,1,1}, {1,0,1}, {1,0,0}},
+     {{0,0,1}, {0,1,1}, {1,0,0}, {0,0,0}},
+     {{0,1,1}, {1,0,0}, {0,1,0}, {1,1,0}},
+     {{1,0,1}, {1,0,0}, {0,1,1}, {1,1,1}},
+     {{1,1,1}, {1,0,0}, {0,1,1}, {1,1,0}}};
+
+  // Fill p (3 x np), e (10 x ne) and t (5 x nt) with the mesh built by
+  // msh3m_structured_mesh, with the same numbering as the m-file.
+  inline void
+  structured_mesh_3d (const double *x, index_t nx,
+                      const double *y, index_t ny,
+                      const double *z, index_t nz,
+                      double region, const double *sides,
+                      double *p, double *e, double *t)
+  {
+    for (index_t iz = 0, k = 0; iz < nz; ++iz)
+      for (index_t ix = 0; ix < nx; ++ix)
+        for (index_t iy = 0; iy < ny; ++iy, ++k)
+          {
+            p[3*k]   = x[ix];
+            p[3*k+1] = y[iy];
+            p[3*k+2] = z[iz];
+          }
+
+    const index_t mx = nx - 1, my = ny - 1, mz = nz - 1;
+    const index_t nc = mx * my * mz;
+    for (int b = 0; b < 6; ++b)
+      for (index_t iz = 0, c = 0; iz < mz; ++iz)
+        for (index_t ix = 0; ix < mx; ++ix)
+          for (index_t iy = 0; iy < my; ++iy, ++c)
+            {
+              double *tj = t + 5 * (b * nc + c);
+              for (int v = 0; v < 4; ++v)
+                {
+                  const int *o = kuhn_offsets[b][v];
+                  tj[v] = (iy + o[1]) + ny * (ix + o[0])
+                    + nx * ny * (iz + o[2]) + 1;
+                }
+              tj[4] = region;
+            }
+
+    // A boundary face is any triple of tetrahedron vertices lying on
+    // one of the six sides; faces are collected side by side scanning
+    // the elements in order and keep the vertex order of the element.
+    const index_t ncell[3] = {mx, my, mz};
+    index_t j = 0;
+    for (int s = 0; s < 6; ++s)
+      {
+        const int axis = s / 2;
+        const index_t plane = (s % 2) ? ncell[axis] : 0;
+        for (int b = 0; b < 6; ++b)
+          for (index_t iz = 0; iz < mz; ++iz)
+            for (index_t ix = 0; ix < mx; ++ix)
+              for (index_t iy = 0; iy < my; ++iy)
+                {
+                  const index_t ijk[3] = {ix, iy, iz};
+                  if (ijk[axis] != plane && ijk[axis] + 1 != plane)
+                    continue;
+
+                  const index_t c = iy + my * (ix + mx * iz);
+                  const double *tj = t + 5 * (b * nc + c);
+                  double face[4];
+                  int on = 0;
+                  for (int v = 0; v < 4; ++v)
+                    if (ijk[axis] + kuhn_offsets[b][v][axis] == plane)
+                      face[on++] = tj[v];
+                  if (on != 3)
+                    continue;
+
+                  double *ej = e + 10 * j++;
+                  ej[0] = face[0];
+                  ej[1] = face[1];
+                  ej[2] = face[2];
+                  for (int r = 3; r < 8; ++r)
+                    ej[r] = 0;
+                  ej[8] = region;
+                  ej[9] = sides[s];
+                }
+      }
+  }
+
+  // Element properties as returned by msh2m_geometrical_properties and
+  // msh3m_geometrical_properties; all output buffers hold one column
+  // (or one page, for "shg" and "midedge") per element and are written
+  // for the elements in [j0, j1) only, so that callers may split the
+  // work among threads.
+
+  // "bar": dim x nt matrix of element centers of mass.
+  template <typename T>
+  void
+  element_bar (const mesh_view<T>& m, index_t j0, index_t j1, double *b)
+  {
+    const int nv = m.dim + 1;
+    for (index_t j = j0; j < j1; ++j)
+      for (int d = 0; d < m.dim; ++d)
+        {
+          double s = 0;
+          for (int k = 0; k < nv; ++k)
+            s += m.point (m.tv (k, j))[d];
+          b[d + m.dim * j] = s / nv;
+        }
+  }
+
+  // Signed Jacobian determinant of the map from the reference element.
+  template <typename T>
+  double
+  element_jacdet (const mesh_view<T>& m, index_t j)
+  {
+    const double *p1 = m.point (m.tv (0, j));
+    const double *p2 = m.point (m.tv (1, j));
+    const double *p3 = m.point (m.tv (2, j));
+    if (m.dim == 2)
+      return (p2[0] - p1[0]) * (p3[1] - p1[1])
+        - (p3[0] - p1[0]) * (p2[1] - p1[1]);
+
+    const double *p4 = m.point (m.tv (3, j));
+    const double Nb2 = p1[1] * (p3[2] - p4[2]) + p3[1] * (p4[2] - p1[2])
+      + p4[1] * (p1[2] - p3[2]);
+    const double Nb3 = p1[1] * (p4[2] - p2[2]) + p2[1] * (p1[2] - p4[2])
+      + p4[1] * (p2[2] - p1[2]);
+    const double Nb4 = p1[1] * (p2[2] - p3[2]) + p2[1] * (p3[2] - p1[2])
+      + p3[1] * (p1[2] - p2[2]);
+    return (p2[0] - p1[0]) * Nb2 + (p3[0] - p1[0]) * Nb3
+      + (p4[0] - p1[0]) * Nb4;
+  }
+
+  // "wjacdet": (dim+1) x nt matrix of Jacobian determinants weighted
+  // for the trapezoidal rule.  As in msh2m_geometrical_properties,
+  // triangles with clockwise orientation are counted as positive.
+  template <typename T>
+  void
+  element_wjacdet (const mesh_view<T>& m, index_t j0, index_t j1, double *w)
+  {
+    const int nv = m.dim + 1;
+    for (index_t j = j0; j < j1; ++j)
+      {
+        double det = element_jacdet (m, j);
+        if (m.dim == 2)
+          det = std::abs (det) / 6;
+        else
+          det /= 24;
+        for (int k = 0; k < nv; ++k)
+          w[k + nv * j] = det;
+      }
+  }
+
+  // "area": area (volume in 3D) of each element.
+  template <typename T>
+  void
+  element_area (const mesh_view<T>& m, index_t j0, index_t j1, double *a)
+  {
+    for (index_t j = j0; j < j1; ++j)
+      {
+        const double det = element_jacdet (m, j);
+        a[j] = m.dim == 2 ? std::abs (det) / 2 : det / 6;
+      }
+  }
+
+  // "shg": dim x (dim+1) x nt array of the gradients of the P1 shape
+  // functions.
+  template <typename T>
+  void
+  element_shg (const mesh_view<T>& m, index_t j0, index_t j1, double *g)
+  {
+    for (index_t j = j0; j < j1; ++j)
+      {
+        const double *p1 = m.point (m.tv (0, j));
+        const double *p2 = m.point (m.tv (1, j));
+        const double *p3 = m.point (m.tv (2, j));
+        if (m.dim == 2)
+          {
+            const double x0 = p1[0], y0 = p1[1], x1 = p2[0], y1 = p2[1];
+            const double x2 = p3[0], y2 = p3[1];
+            const double den = -(x1*y0) + x2*y0 + x0*y1 - x2*y1
+              - x0*y2 + x1*y2;
+            double *gj = g + 6 * j;
+            gj[0] =  (y1 - y2) / den;
+            gj[1] = -(x1 - x2) / den;
+            gj[2] = -(y0 - y2) / den;
+            gj[3] =  (x0 - x2) / den;
+            gj[4] =  (y0 - y1) / den;
+            gj[5] = -(x0 - x1) / den;
+          }
+        else
+          {
+            const double *p4 = m.point (m.tv (3, j));
+            const double x1 = p1[0], y1 = p1[1], z1 = p1[2];
+            const double x2 = p2[0], y2 = p2[1], z2 = p2[2];
+            const double x3 = p3[0], y3 = p3[1], z3 = p3[2];
+            const double x4 = p4[0], y4 = p4[1], z4 = p4[2];
+            const double det = element_jacdet (m, j);
+            double *gj = g + 12 * j;
+            gj[0]  = (y2*(z4-z3) + y3*(z2-z4) + y4*(z3-z2)) / det;
+            gj[1]  = (x2*(z3-z4) + x3*(z4-z2) + x4*(z2-z3)) / det;
+            gj[2]  = (x2*(y4-y3) + x3*(y2-y4) + x4*(y3-y2)) / det;
+            gj[3]  = (y1*(z3-z4) + y3*(z4-z1) + y4*(z1-z3)) / det;
+            gj[4]  = (x1*(z4-z3) + x3*(z1-z4) + x4*(z3-z1)) / det;
+            gj[5]  = (x1*(y3-y4) + x3*(y4-y1) + x4*(y1-y3)) / det;
+            gj[6]  = (y1*(z4-z2) + y2*(z1-z4) + y4*(z2-z1)) / det;
+            gj[7]  = (x1*(z2-z4) + x2*(z4-z1) + x4*(z1-z2)) / det;
+            gj[8]  = (x1*(y4-y2) + x2*(y1-y4) + x4*(y2-y1)) / det;
+            gj[9]  = (y1*(z2-z3) + y2*(z3-z1) + y3*(z1-z2)) / det;
+            gj[10] = (x1*(z3-z2) + x2*(z1-z3) + x3*(z2-z1)) / det;
+            gj[11] = (x1*(y2-y3) + x2*(y3-y1) + x3*(y1-y2)) / det;
+          }
+      }
+  }
+
+  // Local edges of a triangle, edge i being opposite to vertex i as in
+  // the "midedge" and "slength" properties of
+  // msh2m_geometrical_properties.
+  static const int tri_edges[3][2] = {{1, 2}, {2, 0}, {0, 1}};
+
+  // "midedge": 2 x 3 x nt array of the midpoints of the triangle edges.
+  template <typename T>
+  void
+  element_midedge (const mesh_view<T>& m, index_t j0, index_t j1, double *c)
+  {
+    for (index_t j = j0; j < j1; ++j)
+      for (int s = 0; s < 3; ++s)
+        {
+          const double *a = m.point (m.tv (tri_edges[s][0], j));
+          const double *b = m.point (m.tv (tri_edges[s][1], j));
+          c[2 * (s + 3 * j)]     = (a[0] + b[0]) / 2;
+          c[2 * (s + 3 * j) + 1] = (a[1] + b[1]) / 2;
+        }
+  }
+
+  // Write the mesh to fp in the Gmsh ASCII 2.0 format, using the same
+  // layout as msh2m_gmsh_write and msh3m_gmsh_write.  Return false on
+  // a write error.
+  template <typename T>
+  bool
+  gmsh_write (const mesh_view<T>& m, std::FILE *fp)
+  {
+    const int nv = m.dim + 1;
+    const long long ne = m.ne, nt = m.nt;
+    std::fprintf (fp, "$MeshFormat\n2.0 0 8\n$EndMeshFormat\n");
+
+    std::fprintf (fp, "$Nodes\n%lld\n", static_cast<long long> (m.np));
+    for (index_t i = 0; i < m.np; ++i)
+      {
+        const double *x = m.point (i);
+        std::fprintf (fp, "%lld %17.17g %17.17g %17.17g\n",
+                      static_cast<long long> (i + 1), x[0], x[1],
+                      m.dim == 3 ? x[2] : 0.0);
+      }
+    std::fprintf (fp, "$EndNodes\n");
+
+    // Boundary facets carry the geometrical entity in the same row of
+    // e that the m-files use: row 6 in 2D, row 10 in 3D.
+    std::fprintf (fp, "$Elements\n%lld\n", ne + nt);
+    const int erow = m.dim == 2 ? 5 : 9;
+    const int etype = m.dim == 2 ? 1 : 2;
+    for (index_t j = 0; j < m.ne; ++j)
+      {
+        std::fprintf (fp, "%lld %d 3 0 %lld 0", static_cast<long long> (j + 1),
+                      etype, static_cast<long long> (m.elabel (erow, j)));
+        for (int k = 0; k < m.dim; ++k)
+          std::fprintf (fp, " %lld", static_cast<long long> (m.ev (k, j) + 1));
+        std::fprintf (fp, "\n");
+      }
+
+    const int ttype = m.dim == 2 ? 2 : 4;
+    for (index_t j = 0; j < m.nt; ++j)
+      {
+        std::fprintf (fp, "%lld %d 3 0 %lld 0",
+                      static_cast<long long> (ne + j + 1), ttype,
+                      static_cast<long long> (m.region (j)));
+        for (int k = 0; k < nv; ++k)
+          std::fprintf (fp, " %lld", static_cast<long long> (m.tv (k, j) + 1));
+        std::fprintf (fp, "\n");
+      }
+    std::fprintf (fp, "$EndElements\n");
+
+    return ! std::ferror (fp);
+  }
+
+  // Local edges of a tetrahedron, in the order used by Gmsh for
+  // 10-node tetrahedra.
+  static const int tet_edges[6][2] =
+    {{0, 1}, {1, 2}, {2, 0}, {3, 0}, {3, 2}, {3, 1}};
+
+  inline int
+  num_local_edges (int dim)
+  { return dim == 2 ? 3 : 6; }
+
+  inline const int *
+  local_edge (int dim, int k)
+  { return dim == 2 ? tri_edges[k] : tet_edges[k]; }
+
+  // Exclusive prefix sum of v, in place; return the total.
+  inline index_t
+  prefix_sum (std::vector<index_t>& v)
+  {
+    index_t s = 0;
+    for (std::size_t i = 0; i < v.size (); ++i)
+      {
+        const index_t c = v[i];
+        v[i] = s;
+        s += c;
+      }
+    return s;
+  }
+
+  // Unique edges of a mesh.  The edges are bucketed by their lower
+  // vertex with a counting sort, each bucket is then sorted by the
+  // higher vertex, so that edge numbers only depend on the mesh and
+  // not on the number of threads.
+  struct edge_table
+  {
+    std::vector<index_t> ptr;        // np + 1 offsets into hi
+    std::vector<index_t> hi;         // higher vertex of each edge
+    std::vector<index_t> elem_edge;  // edge of local edge k of element j
+
+    index_t num_edges (void) const { return hi.size (); }
+
+    // Lower vertex of edge i.
+    index_t
+    lo (index_t i) const
+    {
+      return std::upper_bound (ptr.begin (), ptr.end (), i)
+        - ptr.begin () - 1;
+    }
+
+    // Edge joining vertices a and b, or -1 if there is none.
+    index_t
+    find (index_t a, index_t b) const
+    {
+      if (a > b)
+        std::swap (a, b);
+      std::vector<index_t>::const_iterator
+        first = hi.begin () + ptr[a], last = hi.begin () + ptr[a+1],
+        it = std::lower_bound (first, last, b);
+      return (it != last && *it == b) ? it - hi.begin () : -1;
+    }
+  };
+
+  template <typename T>
+  void
+  build_edge_table (const mesh_view<T>& m, edge_table& et)
+  {
+    const int nle = num_local_edges (m.dim);
+    const index_t nslots = nle * m.nt;
+
+    // Count the local edges in each bucket.
+    std::vector<index_t> start (m.np + 1, 0);
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      for (int k = 0; k < nle; ++k)
+        {
+          const int *le = local_edge (m.dim, k);
+          const index_t a = std::min (m.tv (le[0], j), m.tv (le[1], j));
+#pragma omp atomic
+          ++start[a];
+        }
+    prefix_sum (start);
+
+    // Scatter (higher vertex, local edge) pairs to the buckets.
+    std::vector<index_t> fill (start.begin (), start.end () - 1);
+    std::vector<std::pair<index_t, index_t> > slot (nslots);
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      for (int k = 0; k < nle; ++k)
+        {
+          const int *le = local_edge (m.dim, k);
+          const index_t a = m.tv (le[0], j), b = m.tv (le[1], j);
+          index_t pos;
+#pragma omp atomic capture
+          pos = fill[std::min (a, b)]++;
+          slot[pos] = std::make_pair (std::max (a, b), nle * j + k);
+        }
+
+    // Sort each bucket and count its distinct edges.
+    et.ptr.assign (m.np + 1, 0);
+#pragma omp parallel for schedule (dynamic, 1024)
+    for (index_t a = 0; a < m.np; ++a)
+      {
+        std::sort (slot.begin () + start[a], slot.begin () + start[a+1]);
+        index_t n = 0;
+        for (index_t s = start[a]; s < start[a+1]; ++s)
+          if (s == start[a] || slot[s].first != slot[s-1].first)
+            ++n;
+        et.ptr[a] = n;
+      }
+    const index_t nedges = prefix_sum (et.ptr);
+
+    // Number the edges.
+    et.hi.resize (nedges);
+    et.elem_edge.resize (nslots);
+#pragma omp parallel for schedule (dynamic, 1024)
+    for (index_t a = 0; a < m.np; ++a)
+      {
+        index_t id = et.ptr[a] - 1;
+        for (index_t s = start[a]; s < start[a+1]; ++s)
+          {
+            if (s == start[a] || slot[s].first != slot[s-1].first)
+              et.hi[++id] = slot[s].first;
+            et.elem_edge[slot[s].second] = id;
+          }
+      }
+  }
+
+  // A planar curve given by two piecewise polynomials in the form
+  // returned by mkpp, such as the splines built by catmullrom.
+  struct pp_curve
+  {
+    const double *breaks;
+    const double *coefs[2];   // pieces x order, one per coordinate
+    index_t pieces;
+    int order;
+
+    index_t
+    piece (double s) const
+    {
+      index_t i = std::upper_bound (breaks, breaks + pieces + 1, s)
+        - breaks - 1;
+      return std::max<index_t> (0, std::min (i, pieces - 1));
+    }
+
+    // Value and first two derivatives of coordinate d at s.
+    void
+    eval (int d, double s, double& f, double& df, double& ddf) const
+    {
+      const index_t i = piece (s);
+      const double h = s - breaks[i];
+      f = df = ddf = 0;
+      for (int k = 0; k < order; ++k)
+        {
+          const double c = coefs[d][i + pieces * k];
+          ddf = ddf * h + 2 * df;
+          df = df * h + f;
+          f = f * h + c;
+        }
+    }
+
+    void
+    point (double s, double *x) const
+    {
+      double df, ddf;
+      eval (0, s, x[0], df, ddf);
+      eval (1, s, x[1], df, ddf);
+    }
+
+    // Parameter of the point of the curve closest to q.
+    double
+    project (const double *q) const
+    {
+      // Coarse search, then Newton on (c(s) - q) . c'(s) = 0.
+      const int nsamp = 8;
+      double best = breaks[0], dbest = HUGE_VAL;
+      for (index_t i = 0; i < pieces; ++i)
+        for (int k = 0; k <= nsamp; ++k)
+          {
+            const double s = breaks[i]
+              + (breaks[i+1] - breaks[i]) * k / nsamp;
+            double x[2];
+            point (s, x);
+            const double d = (x[0] - q[0]) * (x[0] - q[0])
+              + (x[1] - q[1]) * (x[1] - q[1]);
+            if (d < dbest)
+              {
+                dbest = d;
+                best = s;
+              }
+          }
+
+      double s = best;
+      for (int it = 0; it < 20; ++it)
+        {
+          double x, dx, ddx, y, dy, ddy;
+          eval (0, s, x, dx, ddx);
+          eval (1, s, y, dy, ddy);
+          const double g = (x - q[0]) * dx + (y - q[1]) * dy;
+          const double dg = dx * dx + dy * dy
+            + (x - q[0]) * ddx + (y - q[1]) * ddy;
+          if (dg <= 0)
+            break;
+          const double ds = g / dg;
+          s = std::max (breaks[0], std::min (breaks[pieces], s - ds));
+          if (std::abs (ds) <= 1e-14 * (1 + std::abs (s)))
+            break;
+        }
+      return s;
+    }
+  };
+
+  // Promote a P1 mesh to P2.  The mid-edge node of edge i of et is
+  // appended to the nodes as node np + i.  p2 is dim x (np + nedges);
+  // t2 has the rows of t followed by the mid-edge nodes of each
+  // element (in the order of tri_edges or tet_edges); e2 has the rows
+  // of e followed by the mid-edge nodes of each boundary facet, which
+  // for boundary triangles are listed in the order (1,2), (2,3), (3,1).
+  template <typename T>
+  void
+  promote_p2 (const mesh_view<T>& m, const edge_table& et,
+              double *p2, T *e2, T *t2)
+  {
+    const int nle = num_local_edges (m.dim);
+    const index_t t2rows = m.trows + nle;
+
+    std::copy (m.p, m.p + m.dim * m.np, p2);
+#pragma omp parallel for
+    for (index_t i = 0; i < m.np; ++i)
+      for (index_t q = et.ptr[i]; q < et.ptr[i+1]; ++q)
+        {
+          const double *a = m.point (i), *b = m.point (et.hi[q]);
+          for (int d = 0; d < m.dim; ++d)
+            p2[d + m.dim * (m.np + q)] = (a[d] + b[d]) / 2;
+        }
+
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      {
+        for (index_t r = 0; r < m.trows; ++r)
+          t2[r + t2rows * j] = m.t[r + m.trows * j];
+        for (int k = 0; k < nle; ++k)
+          t2[m.trows + k + t2rows * j]
+            = static_cast<T> (m.np + et.elem_edge[nle * j + k] + 1);
+      }
+
+    const int nfe = m.dim == 2 ? 1 : 3;
+    const index_t e2rows = m.erows + nfe;
+#pragma omp parallel for
+    for (index_t j = 0; j < m.ne; ++j)
+      {
+        for (index_t r = 0; r < m.erows; ++r)
+          e2[r + e2rows * j] = m.e[r + m.erows * j];
+        for (int k = 0; k < nfe; ++k)
+          {
+            const index_t a = m.ev (k, j), b = m.ev ((k + 1) % m.dim, j);
+            const index_t q = et.find (a, b);
+            e2[m.erows + k + e2rows * j] = static_cast<T> (q < 0 ? 0
+                                                           : m.np + q + 1);
+          }
+      }
+  }
+
+  // Move the mid-edge nodes of the boundary edges of a 2D P2 mesh
+  // whose label (row 5 of e) is one of labels[0 .. nlabels-1] onto the
+  // curve c, at the parameter halfway between those of the two
+  // vertices of the edge.
+  template <typename T>
+  void
+  project_p2_edges (const mesh_view<T>& m, const T *e2,
+                    index_t e2rows, const double *labels, index_t nlabels,
+                    const pp_curve& c, double *p2)
+  {
+#pragma omp parallel for schedule (dynamic, 64)
+    for (index_t j = 0; j < m.ne; ++j)
+      {
+        const double label = m.elabel (4, j);
+        if (std::find (labels, labels + nlabels, label) == labels + nlabels)
+          continue;
+        const index_t mid = static_cast<index_t> (e2[m.erows + e2rows * j]) - 1;
+        if (mid < 0)
+          continue;
+        const double sa = c.project (m.point (m.ev (0, j)));
+        const double sb = c.project (m.point (m.ev (1, j)));
+        c.point ((sa + sb) / 2, p2 + 2 * mid);
+      }
+  }
+
+  // Vertex to column incidence of the connectivity matrix conn, whose
+  // first nv rows hold vertex numbers starting from base: the columns
+  // containing vertex i are idx[ptr[i]] ... idx[ptr[i+1]-1], in
+  // increasing order.
+  template <typename T>
+  void
+  build_incidence (const T *conn, index_t rows, int nv, index_t ncols,
+                   index_t np, std::vector<index_t>& ptr,
+                   std::vector<index_t>& idx, index_t base = 1)
+  {
+    ptr.assign (np + 1, 0);
+#pragma omp parallel for
+    for (index_t j = 0; j < ncols; ++j)
+      for (int k = 0; k < nv; ++k)
+        {
+          const index_t a = static_cast<index_t> (conn[k + rows * j]) - base;
+#pragma omp atomic
+          ++ptr[a];
+        }
+    prefix_sum (ptr);
+
+    std::vector<index_t> fill (ptr.begin (), ptr.end () - 1);
+    idx.resize (ptr[np]);
+#pragma omp parallel for
+    for (index_t j = 0; j < ncols; ++j)
+      for (int k = 0; k < nv; ++k)
+        {
+          const index_t a = static_cast<index_t> (conn[k + rows * j]) - base;
+          index_t pos;
+#pragma omp atomic capture
+          pos = fill[a]++;
+          idx[pos] = j;
+        }
+
+#pragma omp parallel for schedule (dynamic, 1024)
+    for (index_t a = 0; a < np; ++a)
+      std::sort (idx.begin () + ptr[a], idx.begin () + ptr[a+1]);
+  }
+
+  // Local facets of a tetrahedron, facet k being opposite to vertex k
+  // and oriented outwards when the tetrahedron is positively oriented.
+  static const int tet_faces[4][3] =
+    {{1, 2, 3}, {0, 3, 2}, {0, 1, 3}, {0, 2, 1}};
+
+  inline const int *
+  local_facet (int dim, int k)
+  { return dim == 2 ? tri_edges[k] : tet_faces[k]; }
+
+  // Sorted vertices of local facet k of element j.
+  template <typename T>
+  inline void
+  sorted_facet (const mesh_view<T>& m, index_t j, int k, index_t *v)
+  {
+    const int *lf = local_facet (m.dim, k);
+    for (int i = 0; i < m.dim; ++i)
+      v[i] = m.tv (lf[i], j);
+    if (v[0] > v[1])
+      std::swap (v[0], v[1]);
+    if (m.dim == 3)
+      {
+        if (v[1] > v[2])
+          std::swap (v[1], v[2]);
+        if (v[0] > v[1])
+          std::swap (v[0], v[1]);
+      }
+  }
+
+  // Unique facets (edges in 2D, triangles in 3D) of a mesh, with the
+  // elements they belong to.  As for edge_table, facets are bucketed
+  // by their lowest vertex and sorted within each bucket.
+  struct facet_table
+  {
+    int nvf;                          // vertices per facet
+    std::vector<index_t> ptr;         // np + 1 offsets into the facets
+    std::vector<index_t> verts;       // nvf x nf, sorted vertex numbers
+    std::vector<index_t> cell;        // 2 x nf, first two elements or -1
+    std::vector<index_t> count;       // number of elements of each facet
+    std::vector<index_t> cell_facet;  // facet of local facet k of element j
+
+    index_t num_facets (void) const { return count.size (); }
+
+    // Facet with the nvf vertices in v, or -1 if there is none.
+    index_t
+    find (const index_t *v) const
+    {
+      index_t s[3] = {v[0], v[1], nvf == 3 ? v[2] : 0};
+      if (s[0] > s[1])
+        std::swap (s[0], s[1]);
+      if (nvf == 3)
+        {
+          if (s[1] > s[2])
+            std::swap (s[1], s[2]);
+          if (s[0] > s[1])
+            std::swap (s[0], s[1]);
+        }
+      index_t lo = ptr[s[0]], hi = ptr[s[0]+1];
+      while (lo < hi)
+        {
+          const index_t mid = (lo + hi) / 2;
+          const index_t *w = &verts[nvf * mid];
+          if (w[1] < s[1] || (w[1] == s[1] && nvf == 3 && w[2] < s[2]))
+            lo = mid + 1;
+          else
+            hi = mid;
+        }
+      if (lo < ptr[s[0]+1])
+        {
+          const index_t *w = &verts[nvf * lo];
+          if (w[1] == s[1] && (nvf == 2 || w[2] == s[2]))
+            return lo;
+        }
+      return -1;
+    }
+  };
+
+  template <typename T>
+  void
+  build_facet_table (const mesh_view<T>& m, facet_table& ft)
+  {
+    const int nvf = m.dim, nlf = m.dim + 1;
+    const index_t nslots = nlf * m.nt;
+    typedef std::pair<std::pair<index_t, index_t>, index_t> key_t;
+
+    std::vector<index_t> start (m.np + 1, 0);
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      for (int k = 0; k < nlf; ++k)
+        {
+          index_t v[3] = {0, 0, 0};
+          sorted_facet (m, j, k, v);
+#pragma omp atomic
+          ++start[v[0]];
+        }
+    prefix_sum (start);
+
+    std::vector<index_t> fill (start.begin (), start.end () - 1);
+    std::vector<key_t> slot (nslots);
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      for (int k = 0; k < nlf; ++k)
+        {
+          index_t v[3] = {0, 0, 0};
+          sorted_facet (m, j, k, v);
+          index_t pos;
+#pragma omp atomic capture
+          pos = fill[v[0]]++;
+          slot[pos] = key_t (std::make_pair (v[1], nvf == 3 ? v[2] : 0),
+                             nlf * j + k);
+        }
+
+    ft.nvf = nvf;
+    ft.ptr.assign (m.np + 1, 0);
+#pragma omp parallel for schedule (dynamic, 1024)
+    for (index_t a = 0; a < m.np; ++a)
+      {
+        std::sort (slot.begin () + start[a], slot.begin () + start[a+1]);
+        index_t n = 0;
+        for (index_t s = start[a]; s < start[a+1]; ++s)
+          if (s == start[a] || slot[s].first != slot[s-1].first)
+            ++n;
+        ft.ptr[a] = n;
+      }
+    const index_t nf = prefix_sum (ft.ptr);
+
+    ft.verts.resize (nvf * nf);
+    ft.cell.assign (2 * nf, -1);
+    ft.count.assign (nf, 0);
+    ft.cell_facet.resize (nslots);
+#pragma omp parallel for schedule (dynamic, 1024)
+    for (index_t a = 0; a < m.np; ++a)
+      {
+        index_t id = ft.ptr[a] - 1;
+        for (index_t s = start[a]; s < start[a+1]; ++s)
+          {
+            if (s == start[a] || slot[s].first != slot[s-1].first)
+              {
+                ++id;
+                ft.verts[nvf * id] = a;
+                ft.verts[nvf * id + 1] = slot[s].first.first;
+                if (nvf == 3)
+                  ft.verts[nvf * id + 2] = slot[s].first.second;
+              }
+            if (ft.count[id] < 2)
+              ft.cell[2 * id + ft.count[id]] = slot[s].second / nlf;
+            ++ft.count[id];
+            ft.cell_facet[slot[s].second] = id;
+          }
+      }
+  }
+
+  // Compressed sparse row adjacency: the neighbours of item i are
+  // idx[ptr[i]] ... idx[ptr[i+1]-1].
+  struct csr_graph
+  {
+    std::vector<index_t> ptr, idx;
+
+    index_t size (void) const { return ptr.size () - 1; }
+  };
+
+  // Elements around each node, in increasing order.
+  template <typename T>
+  void
+  build_v2c (const mesh_view<T>& m, csr_graph& g)
+  {
+    build_incidence (m.t, m.trows, m.dim + 1, m.nt, m.np, g.ptr, g.idx);
+  }
+
+  // Nodes sharing an element with node i, other than i itself.
+  template <typename T>
+  void
+  node_neighbours (const mesh_view<T>& m, const csr_graph& v2c, index_t i,
+                   std::vector<index_t>& nb)
+  {
+    nb.clear ();
+    for (index_t q = v2c.ptr[i]; q < v2c.ptr[i+1]; ++q)
+      for (int k = 0; k <= m.dim; ++k)
+        {
+          const index_t v = m.tv (k, v2c.idx[q]);
+          if (v != i)
+            nb.push_back (v);
+        }
+    std::sort (nb.begin (), nb.end ());
+    nb.erase (std::unique (nb.begin (), nb.end ()), nb.end ());
+  }
+
+  // Node to node adjacency, in increasing order, given the node to
+  // element adjacency v2c.  The lists are built twice, once to count
+  // and once to fill, to avoid storing them per thread.
+  template <typename T>
+  void
+  build_v2v (const mesh_view<T>& m, const csr_graph& v2c, csr_graph& g)
+  {
+    g.ptr.assign (m.np + 1, 0);
+#pragma omp parallel
+    {
+      std::vector<index_t> nb;
+#pragma omp for schedule (dynamic, 1024)
+      for (index_t i = 0; i < m.np; ++i)
+        {
+          node_neighbours (m, v2c, i, nb);
+          g.ptr[i] = nb.size ();
+        }
+    }
+    g.idx.resize (prefix_sum (g.ptr));
+
+#pragma omp parallel
+    {
+      std::vector<index_t> nb;
+#pragma omp for schedule (dynamic, 1024)
+      for (index_t i = 0; i < m.np; ++i)
+        {
+          node_neighbours (m, v2c, i, nb);
+          std::copy (nb.begin (), nb.end (), g.idx.begin () + g.ptr[i]);
+        }
+    }
+  }
+
+  // Element to element adjacency through facets: the neighbours of
+  // element j are listed by local facet (facet k being opposite to
+  // vertex k), facets on the boundary contributing none and facets
+  // shared by more than two elements contributing all of them.
+  template <typename T>
+  void
+  build_c2c (const mesh_view<T>& m, csr_graph& g)
+  {
+    const int nlf = m.dim + 1;
+    facet_table ft;
+    build_facet_table (m, ft);
+
+    csr_graph f2c;
+    build_incidence (ft.cell_facet.data (), nlf, nlf, m.nt,
+                     ft.num_facets (), f2c.ptr, f2c.idx, 0);
+
+    g.ptr.assign (m.nt + 1, 0);
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      for (int k = 0; k < nlf; ++k)
+        {
+          const index_t f = ft.cell_facet[nlf * j + k];
+          g.ptr[j] += f2c.ptr[f+1] - f2c.ptr[f] - 1;
+        }
+    g.idx.resize (prefix_sum (g.ptr));
+
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      {
+        index_t pos = g.ptr[j];
+        for (int k = 0; k < nlf; ++k)
+          {
+            const index_t f = ft.cell_facet[nlf * j + k];
+            for (index_t q = f2c.ptr[f]; q < f2c.ptr[f+1]; ++q)
+              if (f2c.idx[q] != j)
+                g.idx[pos++] = f2c.idx[q];
+          }
+      }
+  }
+
+  // First element other than skip containing the n vertices v, or -1.
+  template <typename T>
+  index_t
+  element_with (const mesh_view<T>& m, const csr_graph& v2c,
+                const index_t *v, int n, index_t skip = -1)
+  {
+    for (index_t q = v2c.ptr[v[0]]; q < v2c.ptr[v[0]+1]; ++q)
+      {
+        const index_t c = v2c.idx[q];
+        if (c == skip)
+          continue;
+        int found = 0;
+        for (int a = 0; a < n; ++a)
+          for (int k = 0; k <= m.dim; ++k)
+            if (m.tv (k, c) == v[a])
+              {
+                ++found;
+                break;
+              }
+        if (found == n)
+          return c;
+      }
+    return -1;
+  }
+
+  // Facets belonging to a single element, encoded as (dim+1)*j+k for
+  // local facet k of element j, in increasing order.  Only the vertex
+  // to element incidence is stored, so that the memory used is about
+  // the size of t.
+  template <typename T>
+  void
+  exterior_facets (const mesh_view<T>& m, std::vector<index_t>& ext)
+  {
+    const int nlf = m.dim + 1;
+    csr_graph v2c;
+    build_v2c (m, v2c);
+
+    // A bit per exterior facet of each element.
+    std::vector<unsigned char> mask (m.nt, 0);
+    std::vector<index_t> count (m.nt + 1, 0);
+#pragma omp parallel for schedule (dynamic, 1024)
+    for (index_t j = 0; j < m.nt; ++j)
+      for (int k = 0; k < nlf; ++k)
+        {
+          const int *lf = local_facet (m.dim, k);
+          index_t v[3];
+          for (int a = 0; a < m.dim; ++a)
+            v[a] = m.tv (lf[a], j);
+          if (element_with (m, v2c, v, m.dim, j) < 0)
+            {
+              mask[j] |= 1 << k;
+              ++count[j];
+            }
+        }
+
+    ext.resize (prefix_sum (count));
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      for (int k = 0, pos = 0; k < nlf; ++k)
+        if ((mask[j] >> k) & 1)
+          ext[count[j] + pos++] = nlf * j + k;
+  }
+
+  // Row of e holding the boundary label (side number in 2D, face
+  // number in 3D).
+  inline int
+  label_row (int dim)
+  { return dim == 2 ? 4 : 9; }
+
+  // Boundary facets and nodes grouped by label: for the label
+  // labels[l], the columns of e are fidx[fptr[l]] ... fidx[fptr[l+1]-1]
+  // and their nodes nidx[nptr[l]] ... nidx[nptr[l+1]-1], both sorted
+  // and without repetitions.
+  struct label_index
+  {
+    std::vector<double> labels;
+    std::vector<index_t> fptr, fidx, nptr, nidx;
+
+    index_t num_labels (void) const { return labels.size (); }
+
+    // Position of label in labels, or -1 if no facet has it.
+    index_t
+    find (double label) const
+    {
+      std::vector<double>::const_iterator it
+        = std::lower_bound (labels.begin (), labels.end (), label);
+      return it != labels.end () && *it == label ? it - labels.begin () : -1;
+    }
+  };
+
+  template <typename T>
+  void
+  build_label_index (const mesh_view<T>& m, label_index& li)
+  {
+    const int lrow = label_row (m.dim);
+    std::vector<double> lab (m.ne);
+#pragma omp parallel for
+    for (index_t j = 0; j < m.ne; ++j)
+      lab[j] = m.elabel (lrow, j);
+
+    li.labels = lab;
+    std::sort (li.labels.begin (), li.labels.end ());
+    li.labels.erase (std::unique (li.labels.begin (), li.labels.end ()),
+                     li.labels.end ());
+
+    std::vector<index_t> pos (m.ne);
+#pragma omp parallel for
+    for (index_t j = 0; j < m.ne; ++j)
+      pos[j] = li.find (lab[j]);
+    const index_t nl = li.num_labels ();
+    build_incidence (pos.data (), 1, 1, m.ne, nl, li.fptr, li.fidx, 0);
+
+    std::vector<std::vector<index_t> > nodes (nl);
+#pragma omp parallel for schedule (dynamic, 1)
+    for (index_t l = 0; l < nl; ++l)
+      {
+        std::vector<index_t>& v = nodes[l];
+        v.reserve (m.dim * (li.fptr[l+1] - li.fptr[l]));
+        for (index_t q = li.fptr[l]; q < li.fptr[l+1]; ++q)
+          for (int k = 0; k < m.dim; ++k)
+            v.push_back (m.ev (k, li.fidx[q]));
+        std::sort (v.begin (), v.end ());
+        v.erase (std::unique (v.begin (), v.end ()), v.end ());
+      }
+
+    li.nptr.assign (nl + 1, 0);
+    for (index_t l = 0; l < nl; ++l)
+      li.nptr[l] = nodes[l].size ();
+    li.nidx.resize (prefix_sum (li.nptr));
+#pragma omp parallel for schedule (dynamic, 1)
+    for (index_t l = 0; l < nl; ++l)
+      std::copy (nodes[l].begin (), nodes[l].end (),
+                 li.nidx.begin () + li.nptr[l]);
+  }
+
+  // Union of the sorted lists idx[ptr[l]-base] ... idx[ptr[l+1]-base-1]
+  // for the label positions l in sel (negative ones being skipped),
+  // merged pairwise without rescanning the mesh.
+  template <typename V>
+  void
+  merge_sorted_lists (const V *ptr, const V *idx, index_t base,
+                      const index_t *sel, index_t nsel, std::vector<V>& out)
+  {
+    std::vector<std::vector<V> > lists;
+    for (index_t s = 0; s < nsel; ++s)
+      if (sel[s] >= 0)
+        {
+          const V *first = idx + static_cast<index_t> (ptr[sel[s]]) - base;
+          const V *last = idx + static_cast<index_t> (ptr[sel[s]+1]) - base;
+          lists.push_back (std::vector<V> (first, last));
+        }
+    while (lists.size () > 1)
+      {
+        const index_t npairs = lists.size () / 2, half = lists.size () - npairs;
+#pragma omp parallel for schedule (dynamic, 1) if (npairs > 4)
+        for (index_t a = 0; a < npairs; ++a)
+          {
+            const std::vector<V>& x = lists[a];
+            const std::vector<V>& y = lists[a + half];
+            std::vector<V> u;
+            u.reserve (x.size () + y.size ());
+            std::set_union (x.begin (), x.end (), y.begin (), y.end (),
+                            std::back_inserter (u));
+            lists[a].swap (u);
+          }
+        lists.resize (half);
+      }
+    if (lists.empty ())
+      out.clear ();
+    else
+      out.swap (lists[0]);
+  }
+
+  // Disjoint sets of the items 0 ... n-1.  Sets are joined under their
+  // lowest numbered item, which is thus the root of each set.
+  struct disjoint_sets
+  {
+    std::vector<index_t> parent;
+
+    explicit disjoint_sets (index_t n) : parent (n)
+    {
+      for (index_t i = 0; i < n; ++i)
+        parent[i] = i;
+    }
+
+    index_t
+    find (index_t i)
+    {
+      while (parent[i] != i)
+        i = parent[i] = parent[parent[i]];
+      return i;
+    }
+
+    void
+    join (index_t a, index_t b)
+    {
+      a = find (a);
+      b = find (b);
+      if (a < b)
+        parent[b] = a;
+      else
+        parent[a] = b;
+    }
+  };
+
+  // Representative of each node: the lowest numbered node connected
+  // to it by a chain of nodes within distance tol of each other, or the
+  // node itself.  Nodes are bucketed on a grid of spacing h >= tol and
+  // sorted by bucket, so that only the neighbouring buckets are
+  // searched; the pairs found are then joined in disjoint sets.
+  inline void
+  find_duplicate_nodes (const double *p, int dim, index_t np, double tol,
+                        double h, std::vector<index_t>& rep)
+  {
+    typedef std::pair<long long, long long> pair_t;
+    typedef std::pair<pair_t, std::pair<long long, index_t> > bucket_t;
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL};
+    for (index_t i = 0; i < np; ++i)
+      for (int d = 0; d < dim; ++d)
+        lo[d] = std::min (lo[d], p[dim * i + d]);
+
+    std::vector<bucket_t> order (np);
+#pragma omp parallel for
+    for (index_t i = 0; i < np; ++i)
+      {
+        long long c[3] = {0, 0, 0};
+        for (int d = 0; d < dim; ++d)
+          c[d] = static_cast<long long> (std::floor ((p[dim * i + d] - lo[d])
+                                                     / h));
+        order[i] = bucket_t (pair_t (c[0], c[1]), std::make_pair (c[2], i));
+      }
+    std::sort (order.begin (), order.end ());
+
+    // Each pair is found from its higher numbered node.  Duplicates are
+    // rare, so that the pairs are simply gathered per thread.
+    std::vector<std::pair<index_t, index_t> > close;
+    const int nnb = dim == 2 ? 9 : 27;
+#pragma omp parallel
+    {
+      std::vector<std::pair<index_t, index_t> > found;
+#pragma omp for schedule (dynamic, 1024)
+      for (index_t s = 0; s < np; ++s)
+        {
+          const index_t i = order[s].second.second;
+          const double *x = p + dim * i;
+          for (int n = 0; n < nnb; ++n)
+            {
+              const int dx = n % 3 - 1, dy = n / 3 % 3 - 1;
+              const int dz = dim == 3 ? n / 9 - 1 : 0;
+              const bucket_t key (pair_t (order[s].first.first + dx,
+                                          order[s].first.second + dy),
+                                  std::make_pair (order[s].second.first + dz,
+                                                  index_t (-1)));
+              for (std::vector<bucket_t>::const_iterator it
+                     = std::lower_bound (order.begin (), order.end (), key);
+                   it != order.end () && it->first == key.first
+                     && it->second.first == key.second.first
+                     && it->second.second < i; ++it)
+                {
+                  const double *y = p + dim * it->second.second;
+                  double d2 = 0;
+                  for (int d = 0; d < dim; ++d)
+                    d2 += (x[d] - y[d]) * (x[d] - y[d]);
+                  if (d2 <= tol * tol)
+                    found.push_back (std::make_pair (i, it->second.second));
+                }
+            }
+        }
+#pragma omp critical
+      close.insert (close.end (), found.begin (), found.end ());
+    }
+
+    disjoint_sets sets (np);
+    for (std::size_t k = 0; k < close.size (); ++k)
+      sets.join (close[k].first, close[k].second);
+    rep.resize (np);
+    for (index_t i = 0; i < np; ++i)
+      rep[i] = sets.find (i);
+  }
+
+  // Keep, among the n items at the points x (dim x n) with cand set,
+  // the lowest numbered one in each cell of a grid with about budget
+  // cells over their bounding box, so that about budget items are kept
+  // and they are evenly spread.  Directions in which the box is thinner
+  // than the cells get a single cell, so that the grid has at most
+  // 2^dim budget cells however elongated the box is.
+  inline void
+  thin_on_grid (const double *x, int dim, index_t n,
+                const std::vector<unsigned char>& cand, double budget,
+                std::vector<unsigned char>& keep)
+  {
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL};
+    double hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (index_t i = 0; i < n; ++i)
+      if (cand[i])
+        for (int d = 0; d < dim; ++d)
+          {
+            lo[d] = std::min (lo[d], x[dim * i + d]);
+            hi[d] = std::max (hi[d], x[dim * i + d]);
+          }
+
+    bool wide[3] = {false, false, false};
+    for (int d = 0; d < dim; ++d)
+      wide[d] = hi[d] > lo[d];
+    double h = 1;
+    for (bool changed = true; changed; )
+      {
+        double vol = 1;
+        int nwide = 0;
+        for (int d = 0; d < dim; ++d)
+          if (wide[d])
+            {
+              vol *= hi[d] - lo[d];
+              ++nwide;
+            }
+        if (nwide == 0)
+          break;
+        h = std::pow (vol / std::max (budget, 1.0), 1.0 / nwide);
+        changed = false;
+        for (int d = 0; d < dim; ++d)
+          if (wide[d] && hi[d] - lo[d] < h)
+            {
+              wide[d] = false;
+              changed = true;
+            }
+      }
+    index_t size[3] = {1, 1, 1};
+    for (int d = 0; d < dim; ++d)
+      if (wide[d])
+        size[d] = static_cast<index_t> ((hi[d] - lo[d]) / h) + 1;
+
+    std::vector<index_t> cell (n, -1);
+#pragma omp parallel for
+    for (index_t i = 0; i < n; ++i)
+      if (cand[i])
+        {
+          index_t c = 0;
+          for (int d = dim - 1; d >= 0; --d)
+            {
+              const index_t k = wide[d]
+                ? std::min (static_cast<index_t> ((x[dim * i + d] - lo[d])
+                                                  / h), size[d] - 1)
+                : 0;
+              c = c * size[d] + k;
+            }
+          cell[i] = c;
+        }
+
+    std::vector<unsigned char> taken (size[0] * size[1] * size[2], 0);
+    keep.assign (n, 0);
+    for (index_t i = 0; i < n; ++i)
+      if (cell[i] >= 0 && ! taken[cell[i]])
+        taken[cell[i]] = keep[i] = 1;
+  }
+
+  // Interleave the low 21 bits of the dim coordinates in q, giving the
+  // position of a point of a 2^21 grid along a Morton curve.
+  inline std::uint64_t
+  morton_key (const std::uint64_t *q, int dim)
+  {
+    std::uint64_t key = 0;
+    for (int b = 20; b >= 0; --b)
+      for (int d = dim - 1; d >= 0; --d)
+        key = (key << 1) | ((q[d] >> b) & 1);
+    return key;
+  }
+
+  // Renumbering for locality: elem lists the elements in the order of
+  // their centers along a Morton curve, and node[i] is the new 0-based
+  // number of node i, given in order of first appearance in the sorted
+  // elements (unused nodes last, in their original order).  Ties are
+  // broken by element number, so the result does not depend on the
+  // number of threads.
+  template <typename T>
+  void
+  locality_order (const mesh_view<T>& m, std::vector<index_t>& elem,
+                  std::vector<index_t>& node)
+  {
+    const int dim = m.dim;
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL};
+    double hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (index_t i = 0; i < m.np; ++i)
+      for (int d = 0; d < dim; ++d)
+        {
+          lo[d] = std::min (lo[d], m.point (i)[d]);
+          hi[d] = std::max (hi[d], m.point (i)[d]);
+        }
+
+    const double cells = (1 << 21) - 1;
+    std::vector<std::pair<std::uint64_t, index_t> > key (m.nt);
+#pragma omp parallel for
+    for (index_t j = 0; j < m.nt; ++j)
+      {
+        std::uint64_t q[3] = {0, 0, 0};
+        for (int d = 0; d < dim; ++d)
+          {
+            double c = 0;
+            for (int k = 0; k <= dim; ++k)
+              c += m.point (m.tv (k, j))[d];
+            c /= dim + 1;
+            if (hi[d] > lo[d])
+              q[d] = static_cast<std::uint64_t> ((c - lo[d]) / (hi[d] - lo[d])
+                                                 * cells + 0.5);
+          }
+        key[j] = std::make_pair (morton_key (q, dim), j);
+      }
+    std::sort (key.begin (), key.end ());
+
+    elem.resize (m.nt);
+    node.assign (m.np, -1);
+    index_t next = 0;
+    for (index_t k = 0; k < m.nt; ++k)
+      {
+        elem[k] = key[k].second;
+        for (int v = 0; v <= dim; ++v)
+          {
+            index_t& n = node[m.tv (v, elem[k])];
+            if (n < 0)
+              n = next++;
+          }
+      }
+    for (index_t i = 0; i < m.np; ++i)
+      if (node[i] < 0)
+        node[i] = next++;
+  }
+}
+
+#endif
@@ -0,0 +1,476 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Helpers to pass PDE-tool like mesh structures from Octave to the
+// kernels in msh_kernels.h.  All the functions here must be called
+// from the interpreter thread only.
+//
+// Two representations of a mesh are accepted.  The usual one has the
+// double fields p, e and t.  The compact one, built by mshm_compact,
+// has
+//   p         double, as usual;
+//   t         int32, the node rows of t (all rows but the region);
+//   tregion   int16 or int32, the region of each element;
+//   e         int32, the node rows of e (rows 1 to dim and any row
+//             after the tags, such as the mid-edge nodes of P2 meshes);
+//   etags     int16 or int32, the rows of e holding tags that are not
+//             identically zero;
+//   etagrows  the row numbers of etags in the usual layout;
+//   erows     the number of node and tag rows of e in the usual layout
+//             (7 in 2D and 10 in 3D for meshes built by the package).
+
+#if ! defined (MSH_OCTAVE_H)
+#define MSH_OCTAVE_H 1
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <octave/int16NDArray.h>
+#include <octave/int32NDArray.h>
+#include <cmath>
+#include <string>
+
+#include "msh_kernels.h"
+
+namespace msh
+{
+  // Number of node and tag rows of e in the usual layout.
+  inline index_t
+  standard_erows (int dim)
+  { return dim == 2 ? 7 : 10; }
+
+  inline const int32_t *
+  int32_data (const int32NDArray& a)
+  { return reinterpret_cast<const int32_t *> (a.data ()); }
+
+  inline const int16_t *
+  int16_data (const int16NDArray& a)
+  { return reinterpret_cast<const int16_t *> (a.data ()); }
+
+  // Writable data of the arrays filled by the kernels.
+  inline double *
+  writable_data (NDArray& a)
+  { return a.fortran_vec (); }
+
+  inline int32_t *
+  writable_data (int32NDArray& a)
+  { return reinterpret_cast<int32_t *> (a.fortran_vec ()); }
+
+  // Column vector with the entries of v plus one, for returning
+  // 0-based node, facet or element numbers to Octave.
+  inline ColumnVector
+  one_based (const std::vector<index_t>& v)
+  {
+    const index_t n = v.size ();
+    ColumnVector a (n);
+    double *avec = a.fortran_vec ();
+#pragma omp parallel for
+    for (index_t i = 0; i < n; ++i)
+      avec[i] = v[i] + 1;
+    return a;
+  }
+
+  // Keep a reference to the fields of a mesh structure and expose them
+  // as a mesh_view.  The constructor checks the layout of the fields
+  // and that all the connectivity entries are valid node numbers, so
+  // that the kernels need not do it.  For compact meshes cview ()
+  // gives an int32 view; view () is only valid for the usual layout.
+  class octave_mesh
+  {
+  public:
+
+    octave_mesh (void)
+      : m_compact (false), m_label_rows (0), m_p (), m_e (), m_t (),
+        m_view (), m_cview ()
+    { }
+
+    octave_mesh (const octave_value& val, const std::string& caller)
+    { init (val, caller); }
+
+    void
+    init (const octave_value& val, const std::string& caller)
+    {
+      if (! (val.isstruct () && val.numel () == 1))
+        error ("%s: first input is not a valid mesh structure.",
+               caller.c_str ());
+
+      octave_scalar_map s = val.scalar_map_value ();
+      if (! (s.isfield ("p") && s.isfield ("e") && s.isfield ("t")))
+        error ("%s: first input is not a valid mesh structure.",
+               caller.c_str ());
+
+      m_p = s.contents ("p").array_value ();
+      int dim = m_p.rows ();
+      if (dim < 2 || dim > 3)
+        error ("%s: only 2D or 3D meshes are supported", caller.c_str ());
+
+      m_compact = s.contents ("t").is_int32_type ();
+      if (m_compact)
+        init_compact (s, dim, caller);
+      else
+        init_full (s, dim, caller);
+    }
+
+    bool compact (void) const { return m_compact; }
+
+    const mesh_view<double>& view (void) const { return m_view; }
+    const mesh_view<int32_t>& cview (void) const { return m_cview; }
+
+    int dim (void) const { return m_p.rows (); }
+    index_t np (void) const { return m_p.cols (); }
+    index_t ne (void) const
+    { return m_compact ? m_cview.ne : m_view.ne; }
+    index_t nt (void) const
+    { return m_compact ? m_cview.nt : m_view.nt; }
+
+    // Number of node and tag rows of e in the usual layout, that is
+    // not counting rows of extra nodes such as the P2 mid-edge nodes.
+    index_t label_rows (void) const { return m_label_rows; }
+
+    const NDArray& p (void) const { return m_p; }
+
+    // The e and t fields in the usual layout; for compact meshes they
+    // are rebuilt from the compact fields.
+    NDArray e (void) const { return m_compact ? expand_e () : m_e; }
+    NDArray t (void) const { return m_compact ? expand_t () : m_t; }
+
+    // The tag fields of a compact mesh, to be passed on unchanged to
+    // meshes derived from it.
+    const octave_value& tregion (void) const { return m_tregion; }
+    const octave_value& etags (void) const { return m_etags; }
+    const octave_value& etagrows (void) const { return m_etagrows; }
+
+  private:
+
+    void
+    init_full (const octave_scalar_map& s, int dim, const std::string& caller)
+    {
+      m_e = s.contents ("e").array_value ();
+      m_t = s.contents ("t").array_value ();
+
+      if (m_t.rows () < dim + 2)
+        error ("%s: the mesh field t must have at least %d rows",
+               caller.c_str (), dim + 2);
+      if (! m_e.isempty () && m_e.rows () < dim)
+        error ("%s: the mesh field e must have at least %d rows",
+               caller.c_str (), dim);
+
+      m_view.dim = dim;
+      m_view.np = m_p.cols ();
+      m_view.ne = m_e.isempty () ? 0 : m_e.cols ();
+      m_view.nt = m_t.cols ();
+      m_view.p = m_p.data ();
+      m_view.e = m_e.data ();
+      m_view.t = m_t.data ();
+      m_view.erows = m_e.rows ();
+      m_view.trows = m_t.rows ();
+      m_view.set_inline_tags ();
+      m_label_rows = std::min (m_view.erows, standard_erows (dim));
+
+      check_nodes (m_view, caller);
+    }
+
+    void
+    init_compact (const octave_scalar_map& s, int dim,
+                  const std::string& caller)
+    {
+      if (! (s.isfield ("tregion") && s.isfield ("etags")
+             && s.isfield ("etagrows") && s.isfield ("erows")
+             && s.contents ("e").is_int32_type ()))
+        error ("%s: first input is not a valid mesh structure.",
+               caller.c_str ());
+
+      m_e32 = s.contents ("e").int32_array_value ();
+      m_t32 = s.contents ("t").int32_array_value ();
+      m_tregion = s.contents ("tregion");
+      m_etags = s.contents ("etags");
+      m_etagrows = s.contents ("etagrows");
+      m_label_rows = s.contents ("erows").idx_type_value ();
+
+      if (m_t32.rows () < dim + 1)
+        error ("%s: the mesh field t must have at least %d rows",
+               caller.c_str (), dim + 1);
+      if (! m_e32.isempty () && m_e32.rows () < dim)
+        error ("%s: the mesh field e must have at least %d rows",
+               caller.c_str (), dim);
+
+      m_cview.dim = dim;
+      m_cview.np = m_p.cols ();
+      m_cview.ne = m_e32.isempty () ? 0 : m_e32.cols ();
+      m_cview.nt = m_t32.cols ();
+      m_cview.p = m_p.data ();
+      m_cview.e = int32_data (m_e32);
+      m_cview.t = int32_data (m_t32);
+      m_cview.erows = m_e32.rows ();
+      m_cview.trows = m_t32.rows ();
+
+      if (m_tregion.numel () != m_cview.nt)
+        error ("%s: the mesh field tregion must have one entry for each "
+               "element", caller.c_str ());
+      m_cview.treg = tag_row_of (m_tregion, 0, 1, m_treg16, m_treg32,
+                                 caller);
+
+      NDArray rows = m_etagrows.array_value ();
+      const index_t ntags = rows.numel ();
+      if ((m_cview.ne > 0 && m_label_rows < dim) || m_label_rows > max_erows
+          || (ntags > 0 && (m_etags.rows () != ntags
+                            || m_etags.columns () != m_cview.ne)))
+        error ("%s: the mesh fields etags, etagrows and erows do not match",
+               caller.c_str ());
+      for (index_t k = 0; k < ntags; ++k)
+        {
+          const double r = rows(k);
+          if (r != std::floor (r) || r <= dim || r > m_label_rows)
+            error ("%s: invalid row number %g in etagrows", caller.c_str (),
+                   r);
+          m_cview.etag[static_cast<int> (r) - 1]
+            = tag_row_of (m_etags, k, ntags, m_etags16, m_etags32, caller);
+        }
+
+      check_nodes (m_cview, caller);
+    }
+
+    // Tag row k of the int16 or int32 array val, with ntags rows.  The
+    // array is kept alive in a16 or a32.
+    static tag_row
+    tag_row_of (const octave_value& val, index_t k, index_t ntags,
+                int16NDArray& a16, int32NDArray& a32,
+                const std::string& caller)
+    {
+      if (val.is_int16_type ())
+        {
+          a16 = val.int16_array_value ();
+          return tag_row (int16_data (a16) + k, ntags);
+        }
+      else if (val.is_int32_type ())
+        {
+          a32 = val.int32_array_value ();
+          return tag_row (int32_data (a32) + k, ntags);
+        }
+      error ("%s: the tags of a compact mesh must be int16 or int32",
+             caller.c_str ());
+      return tag_row ();
+    }
+
+    template <typename T>
+    void
+    check_nodes (const mesh_view<T>& v, const std::string& caller) const
+    {
+      for (index_t j = 0; j < v.nt; ++j)
+        for (int k = 0; k <= v.dim; ++k)
+          check_node (v.tv (k, j), v.np, caller);
+      for (index_t j = 0; j < v.ne; ++j)
+        for (int k = 0; k < v.dim; ++k)
+          check_node (v.ev (k, j), v.np, caller);
+    }
+
+    void
+    check_node (index_t i, index_t np, const std::string& caller) const
+    {
+      if (i < 0 || i >= np)
+        error ("%s: node index %ld out of bounds", caller.c_str (),
+               static_cast<long> (i + 1));
+    }
+
+    NDArray
+    expand_t (void) const
+    {
+      const mesh_view<int32_t>& v = m_cview;
+      const index_t rows = v.trows + 1;
+      NDArray t (dim_vector (rows, v.nt));
+      double *tvec = t.fortran_vec ();
+#pragma omp parallel for
+      for (index_t j = 0; j < v.nt; ++j)
+        {
+          double *col = tvec + rows * j;
+          const int32_t *src = v.t + v.trows * j;
+          for (int k = 0; k <= v.dim; ++k)
+            col[k] = src[k];
+          col[v.dim + 1] = v.region (j);
+          for (index_t k = v.dim + 1; k < v.trows; ++k)
+            col[k + 1] = src[k];
+        }
+      return t;
+    }
+
+    NDArray
+    expand_e (void) const
+    {
+      const mesh_view<int32_t>& v = m_cview;
+      if (v.ne == 0)
+        return NDArray (dim_vector (m_e32.rows () > 0 ? m_label_rows : 0,
+                                    0));
+      const index_t rows = m_label_rows + v.erows - v.dim;
+      NDArray e (dim_vector (rows, v.ne));
+      double *evec = e.fortran_vec ();
+#pragma omp parallel for
+      for (index_t j = 0; j < v.ne; ++j)
+        {
+          double *col = evec + rows * j;
+          const int32_t *src = v.e + v.erows * j;
+          for (int k = 0; k < v.dim; ++k)
+            col[k] = src[k];
+          for (index_t r = v.dim; r < m_label_rows; ++r)
+            col[r] = v.elabel (r, j);
+          for (index_t k = v.dim; k < v.erows; ++k)
+            col[m_label_rows + k - v.dim] = src[k];
+        }
+      return e;
+    }
+
+    bool m_compact;
+    index_t m_label_rows;
+    NDArray m_p, m_e, m_t;
+    int32NDArray m_e32, m_t32, m_treg32, m_etags32;
+    int16NDArray m_treg16, m_etags16;
+    octave_value m_tregion, m_etags, m_etagrows;
+    mesh_view<double> m_view;
+    mesh_view<int32_t> m_cview;
+  };
+
+  // Build the PDE-tool like structure returned to Octave.
+  inline octave_scalar_map
+  make_mesh (const NDArray& p, const NDArray& e, const NDArray& t)
+  {
+    octave_scalar_map a;
+    a.setfield ("p", p);
+    a.setfield ("e", e);
+    a.setfield ("t", t);
+    return a;
+  }
+
+  // Build a compact mesh structure from its fields.
+  inline octave_scalar_map
+  make_compact_mesh (const NDArray& p, const int32NDArray& e,
+                     const int32NDArray& t, const octave_value& tregion,
+                     const octave_value& etags, const octave_value& etagrows,
+                     index_t erows)
+  {
+    octave_scalar_map a;
+    a.setfield ("p", p);
+    a.setfield ("e", e);
+    a.setfield ("t", t);
+    a.setfield ("tregion", tregion);
+    a.setfield ("etags", etags);
+    a.setfield ("etagrows", etagrows);
+    a.setfield ("erows", static_cast<double> (erows));
+    return a;
+  }
+
+  // Store the selected rows of the columns of src (rows x n) as an
+  // int16 array if all the values fit, as int32 otherwise.
+  inline octave_value
+  compact_tags (const double *src, index_t rows, index_t n,
+                const std::vector<index_t>& sel, const std::string& caller)
+  {
+    const index_t ns = sel.size ();
+    bool fits16 = true;
+    for (index_t j = 0; j < n; ++j)
+      for (index_t k = 0; k < ns; ++k)
+        {
+          const double x = src[sel[k] + rows * j];
+          if (x != std::floor (x) || x < -2147483648.0 || x > 2147483647.0)
+            error ("%s: the region and side numbers must be integers",
+                   caller.c_str ());
+          fits16 = fits16 && x >= -32768 && x <= 32767;
+        }
+
+    if (fits16)
+      {
+        int16NDArray a (dim_vector (ns, n));
+        int16_t *dst = reinterpret_cast<int16_t *> (a.fortran_vec ());
+        for (index_t j = 0; j < n; ++j)
+          for (index_t k = 0; k < ns; ++k)
+            dst[k + ns * j] = static_cast<int16_t> (src[sel[k] + rows * j]);
+        return a;
+      }
+    int32NDArray a (dim_vector (ns, n));
+    int32_t *dst = writable_data (a);
+    for (index_t j = 0; j < n; ++j)
+      for (index_t k = 0; k < ns; ++k)
+        dst[k + ns * j] = static_cast<int32_t> (src[sel[k] + rows * j]);
+    return a;
+  }
+
+  // Copy the selected rows of the columns of src (rows x n) to an
+  // int32 array.
+  inline int32NDArray
+  compact_nodes (const double *src, index_t rows, index_t n,
+                 const std::vector<index_t>& sel)
+  {
+    const index_t ns = sel.size ();
+    int32NDArray a (dim_vector (ns, n));
+    int32_t *dst = writable_data (a);
+#pragma omp parallel for
+    for (index_t j = 0; j < n; ++j)
+      for (index_t k = 0; k < ns; ++k)
+        dst[k + ns * j] = static_cast<int32_t> (src[sel[k] + rows * j]);
+    return a;
+  }
+
+  // Convert the fields of a mesh in the usual layout to the compact
+  // representation.  Tag rows of e that are zero everywhere are
+  // dropped.
+  inline octave_scalar_map
+  compact_mesh (const NDArray& p, const NDArray& e, const NDArray& t,
+                const std::string& caller)
+  {
+    const int dim = p.rows ();
+    const index_t np = p.cols ();
+    if (np > 2147483647)
+      error ("%s: too many nodes for the compact representation",
+             caller.c_str ());
+
+    std::vector<index_t> tnodes, treg (1, dim + 1);
+    for (index_t k = 0; k < t.rows (); ++k)
+      if (k != dim + 1)
+        tnodes.push_back (k);
+    const index_t nt = t.cols ();
+    int32NDArray t32 = compact_nodes (t.data (), t.rows (), nt, tnodes);
+    octave_value tregion = compact_tags (t.data (), t.rows (), nt, treg,
+                                         caller);
+
+    const index_t ne = e.isempty () ? 0 : e.cols ();
+    const index_t erows = e.rows ();
+    const index_t nlabel = std::min (erows, standard_erows (dim));
+    std::vector<index_t> enodes, etag;
+    for (index_t k = 0; k < erows; ++k)
+      if (k < dim || k >= nlabel)
+        enodes.push_back (k);
+      else
+        {
+          bool used = false;
+          for (index_t j = 0; j < ne && ! used; ++j)
+            used = e(k, j) != 0;
+          if (used)
+            etag.push_back (k);
+        }
+
+    RowVector etagrows (etag.size ());
+    for (std::size_t k = 0; k < etag.size (); ++k)
+      etagrows(k) = etag[k] + 1;
+
+    return make_compact_mesh (p, compact_nodes (e.data (), erows, ne, enodes),
+                              t32, tregion,
+                              compact_tags (e.data (), erows, ne, etag,
+                                            caller),
+                              etagrows, nlabel);
+  }
+}
+
+#endif
@@ -0,0 +1,535 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Graded meshes from quadtrees (octrees in 3D).
+//
+// The tree covers a box.  Level 0 is a grid of nearly square (cubic)
+// cells, and a cell of level l is identified by its integer coordinates
+// on the grid of level l, packed in a key with 21 bits per direction.
+// The cells of each level are kept in a sorted vector of keys, which
+// holds both the leaves and the refined cells, so that the tree can be
+// refined and balanced level by level in parallel.
+//
+// After 2:1 balancing, each leaf is split into simplices with a vertex
+// at its center, one for each triangle of its boundary (each segment
+// in 2D).  The sides (faces) of the leaves are split at the vertices of
+// the finer neighbours lying on them, by a rule depending only on the
+// side (face) itself, so that the result is conforming.  In 2D the
+// leaves with no such vertices are split in two triangles instead.
+// Vertices are identified by their coordinates on the grid of level
+// maxlevel + 1, which contains the centers of all the cells and of
+// their faces.
+
+#if ! defined (MSH_OCTREE_H)
+#define MSH_OCTREE_H 1
+
+#include "msh_kernels.h"
+
+namespace msh
+{
+  class octree
+  {
+  public:
+
+    typedef std::uint64_t key_t;
+
+    static const int bits = 21;
+
+    // A tree with the cells of level 0 only.  maxlevel is reduced if
+    // needed, so that the grid of the vertices fits in the keys.  If
+    // the box is so elongated that even the vertices of level 0 do not
+    // fit, the tree is left empty and fits () is false.
+    octree (int dim, const double *lo, const double *hi, int maxlevel)
+      : m_dim (dim), m_maxlevel (std::min (maxlevel, bits - 1)),
+        m_cells (1)
+    {
+      const key_t limit = key_t (1) << bits;
+      double lmin = HUGE_VAL;
+      for (int d = 0; d < dim; ++d)
+        lmin = std::min (lmin, hi[d] - lo[d]);
+      key_t nmax = 1;
+      for (int d = 0; d < 3; ++d)
+        {
+          m_lo[d] = d < dim ? lo[d] : 0;
+          m_n0[d] = 1;
+          if (d < dim)
+            m_n0[d] = std::max<key_t> (1, static_cast<key_t>
+                                       (std::min ((hi[d] - lo[d]) / lmin
+                                                  + 0.5, double (limit))));
+          m_h0[d] = d < dim ? (hi[d] - lo[d]) / m_n0[d] : 0;
+          nmax = std::max (nmax, m_n0[d]);
+        }
+      m_fits = (nmax << 1) < limit;
+      if (! m_fits)
+        return;
+      while (m_maxlevel > 0 && (nmax << (m_maxlevel + 1)) >= limit)
+        --m_maxlevel;
+
+      for (key_t k = 0; k < m_n0[2]; ++k)
+        for (key_t j = 0; j < m_n0[1]; ++j)
+          for (key_t i = 0; i < m_n0[0]; ++i)
+            m_cells[0].push_back (pack (i, j, k));
+    }
+
+    bool fits (void) const { return m_fits; }
+
+    int max_level (void) const { return m_maxlevel; }
+
+    int num_levels (void) const { return m_cells.size (); }
+
+    // Refine the cells larger than the size function, level by level.
+    // size (c, half, n, h) must set h[i] to the desired size in the cell
+    // with center c[dim*i ...] and half widths half[0 ... dim-1]; a cell
+    // is refined if its largest width is larger than h[i].
+    template <typename F>
+    void
+    refine (F& size)
+    {
+      const int nch = 1 << m_dim;
+      for (int l = 0; l < m_maxlevel; ++l)
+        {
+          const std::vector<key_t>& cells = m_cells[l];
+          const index_t n = cells.size ();
+          double half[3], width = 0;
+          for (int d = 0; d < m_dim; ++d)
+            {
+              half[d] = m_h0[d] / (2 << l);
+              width = std::max (width, 2 * half[d]);
+            }
+
+          std::vector<double> c (m_dim * n), h (n);
+#pragma omp parallel for
+          for (index_t q = 0; q < n; ++q)
+            for (int d = 0; d < m_dim; ++d)
+              c[m_dim * q + d] = m_lo[d] + (2 * coord (cells[q], d) + 1)
+                * half[d];
+          size (c.data (), half, n, h.data ());
+
+          std::vector<index_t> count (n + 1, 0);
+#pragma omp parallel for
+          for (index_t q = 0; q < n; ++q)
+            count[q] = width > h[q] ? nch : 0;
+          std::vector<key_t> children (prefix_sum (count));
+          if (children.empty ())
+            break;
+#pragma omp parallel for
+          for (index_t q = 0; q < n; ++q)
+            for (index_t a = count[q]; a < count[q+1]; ++a)
+              children[a] = child (cells[q], a - count[q]);
+          std::sort (children.begin (), children.end ());
+          m_cells.push_back (std::vector<key_t> ());
+          m_cells.back ().swap (children);
+        }
+    }
+
+    // Refine further so that leaves sharing a vertex differ by at most
+    // one level: for each cell of level l, the neighbours of its parent
+    // must exist at level l-1.  Levels are processed from the finest,
+    // so that cells added at level l-1 are checked in turn.
+    void
+    balance (void)
+    {
+      const int nnb = m_dim == 2 ? 9 : 27, nch = 1 << m_dim;
+      for (int l = num_levels () - 1; l >= 2; --l)
+        {
+          std::vector<key_t> parents (m_cells[l].size ());
+#pragma omp parallel for
+          for (index_t q = 0; q < index_t (parents.size ()); ++q)
+            parents[q] = parent (m_cells[l][q]);
+          unique_sort (parents);
+
+          // Cells of level l-2 to be refined, or ~0 for none.
+          const index_t np = parents.size ();
+          std::vector<key_t> need (nnb * np, ~key_t (0));
+#pragma omp parallel for
+          for (index_t q = 0; q < np; ++q)
+            for (int o = 0; o < nnb; ++o)
+              {
+                key_t nb;
+                if (neighbour (parents[q], l - 1, o, nb))
+                  {
+                    const key_t r = parent (nb);
+                    if (! has_cell (l - 1, child (r, 0)))
+                      need[nnb * q + o] = r;
+                  }
+              }
+          unique_sort (need);
+          if (! need.empty () && need.back () == ~key_t (0))
+            need.pop_back ();
+          if (need.empty ())
+            continue;
+
+          std::vector<key_t>& cells = m_cells[l-1];
+          const index_t n0 = cells.size ();
+          cells.resize (n0 + nch * need.size ());
+#pragma omp parallel for
+          for (index_t q = 0; q < index_t (need.size ()); ++q)
+            for (int a = 0; a < nch; ++a)
+              cells[n0 + nch * q + a] = child (need[q], a);
+          std::sort (cells.begin (), cells.end ());
+        }
+    }
+
+    // Build the mesh: p is dim x np, e is 7 x ne (10 x ne in 3D) and t
+    // is (dim+2) x nt, in the layout of msh2m_structured_mesh and
+    // msh3m_structured_mesh, with the sides listed in the same order.
+    void
+    mesh (double region, const double *sides, std::vector<double>& p,
+          std::vector<double>& e, std::vector<double>& t)
+    {
+      const int nv = m_dim + 1, nnb = m_dim == 2 ? 4 : 8;
+
+      std::vector<std::pair<int, key_t> > leaves;
+      for (int l = 0; l < num_levels (); ++l)
+        for (index_t q = 0; q < index_t (m_cells[l].size ()); ++q)
+          if (is_leaf (l, m_cells[l][q]))
+            leaves.push_back (std::make_pair (l, m_cells[l][q]));
+      const index_t nleaves = leaves.size ();
+
+      // Vertices of the leaves, on the grid of level maxlevel + 1.
+      m_corners.resize (nnb * nleaves);
+#pragma omp parallel for
+      for (index_t q = 0; q < nleaves; ++q)
+        {
+          const key_t s = key_t (1) << (m_maxlevel + 1 - leaves[q].first);
+          for (int a = 0; a < nnb; ++a)
+            m_corners[nnb * q + a]
+              = pack ((coord (leaves[q].second, 0) + (a & 1)) * s,
+                      (coord (leaves[q].second, 1) + ((a >> 1) & 1)) * s,
+                      (coord (leaves[q].second, 2) + ((a >> 2) & 1)) * s);
+        }
+      unique_sort (m_corners);
+
+      // The leaves are split in blocks, each one filled by one thread
+      // and concatenated in order, so that the result does not depend
+      // on the number of threads.
+      const index_t nblocks = std::min<index_t> (nleaves,
+                                                 16 * num_threads ());
+      std::vector<std::vector<key_t> > tb (nblocks), eb (nblocks);
+      std::vector<std::vector<int> > sb (nblocks);
+#pragma omp parallel for schedule (dynamic, 1)
+      for (index_t b = 0; b < nblocks; ++b)
+        for (index_t q = nleaves * b / nblocks;
+             q < nleaves * (b + 1) / nblocks; ++q)
+          split_leaf (leaves[q].first, leaves[q].second, tb[b], eb[b],
+                      sb[b]);
+
+      std::vector<key_t> tk, ek;
+      std::vector<int> side;
+      for (index_t b = 0; b < nblocks; ++b)
+        {
+          tk.insert (tk.end (), tb[b].begin (), tb[b].end ());
+          ek.insert (ek.end (), eb[b].begin (), eb[b].end ());
+          side.insert (side.end (), sb[b].begin (), sb[b].end ());
+        }
+
+      std::vector<key_t> verts (tk);
+      unique_sort (verts);
+      const index_t np = verts.size ();
+      const key_t s = key_t (1) << (m_maxlevel + 1);
+      p.resize (m_dim * np);
+#pragma omp parallel for
+      for (index_t i = 0; i < np; ++i)
+        for (int d = 0; d < m_dim; ++d)
+          p[m_dim * i + d] = m_lo[d] + coord (verts[i], d) * (m_h0[d] / s);
+
+      const index_t nt = tk.size () / nv;
+      t.resize ((m_dim + 2) * nt);
+#pragma omp parallel for
+      for (index_t j = 0; j < nt; ++j)
+        {
+          double *tj = &t[(m_dim + 2) * j];
+          for (int k = 0; k < nv; ++k)
+            tj[k] = vertex (verts, tk[nv * j + k]) + 1;
+          tj[nv] = region;
+          if (signed_measure (p, tj) < 0)
+            std::swap (tj[0], tj[1]);
+        }
+
+      const index_t ne = side.size (), erows = m_dim == 2 ? 7 : 10;
+      e.assign (erows * ne, 0.0);
+#pragma omp parallel for
+      for (index_t j = 0; j < ne; ++j)
+        {
+          double *ej = &e[erows * j];
+          for (int k = 0; k < m_dim; ++k)
+            ej[k] = vertex (verts, ek[m_dim * j + k]) + 1;
+          ej[label_row (m_dim)] = sides[side[j]];
+          ej[m_dim == 2 ? 6 : 8] = region;
+        }
+    }
+
+  private:
+
+    static key_t
+    pack (key_t i, key_t j, key_t k)
+    { return i | (j << bits) | (k << (2 * bits)); }
+
+    static key_t
+    coord (key_t c, int d)
+    { return (c >> (bits * d)) & ((key_t (1) << bits) - 1); }
+
+    static key_t
+    parent (key_t c)
+    { return pack (coord (c, 0) / 2, coord (c, 1) / 2, coord (c, 2) / 2); }
+
+    static key_t
+    child (key_t c, int a)
+    {
+      return pack (2 * coord (c, 0) + (a & 1), 2 * coord (c, 1)
+                   + ((a >> 1) & 1), 2 * coord (c, 2) + ((a >> 2) & 1));
+    }
+
+    static void
+    unique_sort (std::vector<key_t>& v)
+    {
+      std::sort (v.begin (), v.end ());
+      v.erase (std::unique (v.begin (), v.end ()), v.end ());
+    }
+
+    bool
+    has_cell (int l, key_t c) const
+    {
+      return l < num_levels ()
+        && std::binary_search (m_cells[l].begin (), m_cells[l].end (), c);
+    }
+
+    bool
+    is_leaf (int l, key_t c) const
+    { return ! has_cell (l + 1, child (c, 0)); }
+
+    bool
+    has_corner (key_t v) const
+    { return std::binary_search (m_corners.begin (), m_corners.end (), v); }
+
+    // Neighbour o (in base 3, 1 being no offset) of cell c of level l,
+    // if it is inside the box.
+    bool
+    neighbour (key_t c, int l, int o, key_t& nb) const
+    {
+      key_t x[3];
+      for (int d = 0; d < 3; ++d, o /= 3)
+        {
+          const int off = d < m_dim ? o % 3 - 1 : 0;
+          if ((off < 0 && coord (c, d) == 0)
+              || (off > 0 && coord (c, d) + 1 == m_n0[d] << l))
+            return false;
+          x[d] = coord (c, d) + off;
+        }
+      nb = pack (x[0], x[1], x[2]);
+      return true;
+    }
+
+    static index_t
+    vertex (const std::vector<key_t>& verts, key_t v)
+    { return std::lower_bound (verts.begin (), verts.end (), v)
+        - verts.begin (); }
+
+    double
+    signed_measure (const std::vector<double>& p, const double *tj) const
+    {
+      const int dim = m_dim;
+      const double *x[4];
+      for (int k = 0; k <= dim; ++k)
+        x[k] = &p[dim * (static_cast<index_t> (tj[k]) - 1)];
+      double a[3][3];
+      for (int r = 0; r < dim; ++r)
+        for (int d = 0; d < dim; ++d)
+          a[r][d] = x[r+1][d] - x[0][d];
+      if (dim == 2)
+        return a[0][0] * a[1][1] - a[0][1] * a[1][0];
+      return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+        - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+        + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    }
+
+    // Key of the vertex with coordinate w along axis a and u, v along
+    // the next two axes (in 2D, with a = 2 the plane of the mesh).
+    static key_t
+    point (int a, key_t w, key_t u, key_t v)
+    {
+      key_t x[3];
+      x[a] = w;
+      x[(a + 1) % 3] = u;
+      x[(a + 2) % 3] = v;
+      return pack (x[0], x[1], x[2]);
+    }
+
+    // Triangles of the square face with corner (u0, v0) and width s in
+    // the plane w of axis a: the face is split in four if the center is
+    // a vertex of a finer leaf, fanned from its center if one of its
+    // sides is split, and cut along the diagonal through its lowest
+    // corner otherwise, so that both leaves sharing it split it alike.
+    void
+    split_square (int a, key_t w, key_t u0, key_t v0, key_t s,
+                  std::vector<key_t>& tri) const
+    {
+      const key_t h = s / 2;
+      if (s > 1 && has_corner (point (a, w, u0 + h, v0 + h)))
+        {
+          for (int q = 0; q < 4; ++q)
+            split_square (a, w, u0 + (q & 1) * h, v0 + (q >> 1) * h, h, tri);
+          return;
+        }
+
+      const key_t ring_u[8] = {u0, u0 + h, u0 + s, u0 + s,
+                               u0 + s, u0 + h, u0, u0};
+      const key_t ring_v[8] = {v0, v0, v0, v0 + h,
+                               v0 + s, v0 + s, v0 + s, v0 + h};
+      key_t ring[8];
+      int n = 0;
+      bool split = false;
+      for (int r = 0; r < 8; ++r)
+        if (r % 2 == 0)
+          ring[n++] = point (a, w, ring_u[r], ring_v[r]);
+        else if (s > 1 && has_corner (point (a, w, ring_u[r], ring_v[r])))
+          {
+            ring[n++] = point (a, w, ring_u[r], ring_v[r]);
+            split = true;
+          }
+
+      if (! split)
+        {
+          // The diagonal through the lowest corner.
+          const int c = std::min_element (ring, ring + 4) - ring;
+          const int t[2][3] = {{c, c + 1, c + 2}, {c, c + 2, c + 3}};
+          for (int k = 0; k < 2; ++k)
+            for (int r = 0; r < 3; ++r)
+              tri.push_back (ring[t[k][r] % 4]);
+        }
+      else
+        {
+          const key_t center = point (a, w, u0 + h, v0 + h);
+          for (int r = 0; r < n; ++r)
+            {
+              tri.push_back (center);
+              tri.push_back (ring[r]);
+              tri.push_back (ring[(r + 1) % n]);
+            }
+        }
+    }
+
+    // Segments of side k of the square with corner (x0, y0) and width
+    // s, counterclockwise.
+    void
+    split_side (key_t x0, key_t y0, key_t s, int k,
+                std::vector<key_t>& seg) const
+    {
+      const key_t cu[5] = {x0, x0 + s, x0 + s, x0, x0};
+      const key_t cv[5] = {y0, y0, y0 + s, y0 + s, y0};
+      const key_t a = pack (cu[k], cv[k], 0), b = pack (cu[k+1], cv[k+1], 0);
+      const key_t m = pack ((cu[k] + cu[k+1]) / 2, (cv[k] + cv[k+1]) / 2, 0);
+      if (s > 1 && has_corner (m))
+        {
+          const key_t v[4] = {a, m, m, b};
+          seg.insert (seg.end (), v, v + 4);
+        }
+      else
+        {
+          seg.push_back (a);
+          seg.push_back (b);
+        }
+    }
+
+    // Simplices of leaf c of level l, and its boundary facets with the
+    // position of their side in the sides argument of mesh.
+    void
+    split_leaf (int l, key_t c, std::vector<key_t>& t,
+                std::vector<key_t>& e, std::vector<int>& side) const
+    {
+      const key_t s = key_t (1) << (m_maxlevel + 1 - l), h = s / 2;
+      const key_t x0 = coord (c, 0) * s, y0 = coord (c, 1) * s;
+      const key_t z0 = coord (c, 2) * s;
+      const key_t top[3] = {m_n0[0] << (m_maxlevel + 1),
+                            m_n0[1] << (m_maxlevel + 1),
+                            m_n0[2] << (m_maxlevel + 1)};
+
+      if (m_dim == 2)
+        {
+          // Sides in the order bottom, right, top, left.
+          std::vector<key_t> seg;
+          const bool outer[4] = {y0 == 0, x0 + s == top[0],
+                                 y0 + s == top[1], x0 == 0};
+          for (int k = 0; k < 4; ++k)
+            {
+              const std::size_t n0 = seg.size ();
+              split_side (x0, y0, s, k, seg);
+              if (outer[k])
+                for (std::size_t q = n0; q < seg.size (); q += 2)
+                  {
+                    e.push_back (seg[q]);
+                    e.push_back (seg[q+1]);
+                    side.push_back (k);
+                  }
+            }
+          if (seg.size () == 8)
+            {
+              const key_t v[6] = {seg[0], seg[1], seg[3],
+                                  seg[0], seg[3], seg[5]};
+              t.insert (t.end (), v, v + 6);
+            }
+          else
+            {
+              const key_t center = pack (x0 + h, y0 + h, 0);
+              for (std::size_t q = 0; q < seg.size (); q += 2)
+                {
+                  t.push_back (center);
+                  t.push_back (seg[q]);
+                  t.push_back (seg[q+1]);
+                }
+            }
+          return;
+        }
+
+      // Faces in the order x = min, x = max, y = min, ... as the sides
+      // of msh3m_structured_mesh.
+      const key_t center = pack (x0 + h, y0 + h, z0 + h);
+      const key_t lo[3] = {x0, y0, z0};
+      std::vector<key_t> tri;
+      for (int f = 0; f < 6; ++f)
+        {
+          const int a = f / 2;
+          const key_t w = lo[a] + (f % 2) * s;
+          tri.clear ();
+          split_square (a, w, lo[(a + 1) % 3], lo[(a + 2) % 3], s, tri);
+          const bool outer = w == 0 || w == top[a];
+          for (std::size_t q = 0; q < tri.size (); q += 3)
+            {
+              t.push_back (center);
+              t.insert (t.end (), tri.begin () + q, tri.begin () + q + 3);
+              if (outer)
+                {
+                  e.insert (e.end (), tri.begin () + q,
+                            tri.begin () + q + 3);
+                  side.push_back (f);
+                }
+            }
+        }
+    }
+
+    int m_dim, m_maxlevel;
+    bool m_fits;
+    double m_lo[3], m_h0[3];
+    key_t m_n0[3];
+    std::vector<std::vector<key_t> > m_cells;
+    std::vector<key_t> m_corners;
+  };
+}
+
+#endif
@@ -0,0 +1,935 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Metric driven local remeshing of triangular and tetrahedral meshes.
+//
+// The mesh is modified by passes of a single kind of operation (edge
+// split, edge collapse, edge swap, vertex smoothing).  In each pass the
+// candidate operations are evaluated on the current mesh, sorted by
+// priority, and a set of operations touching disjoint sets of elements
+// is selected and applied in parallel; the outcome does not depend on
+// the number of threads.
+//
+// Nodes lying on boundary sides or faces, on the interfaces between
+// regions or on the outer boundary are features: they are never moved
+// and, in 3D, never removed.  In 2D a feature node can be collapsed
+// along a straight feature line with a single label.  The columns of e
+// and the region numbers in t are carried over to the split elements.
+
+#if ! defined (MSH_REMESH_H)
+#define MSH_REMESH_H 1
+
+#include <atomic>
+#include <iterator>
+#include <limits>
+
+#include "msh_kernels.h"
+
+namespace msh
+{
+  // Symmetric metric tensors are stored by their upper triangle, that
+  // is (m11, m12, m22) in 2D and (m11, m12, m13, m22, m23, m33) in 3D.
+  inline int
+  metric_size (int dim)
+  { return dim == 2 ? 3 : 6; }
+
+  // Squared length of the vector d in the metric M.
+  inline double
+  metric_dot (int dim, const double *M, const double *d)
+  {
+    if (dim == 2)
+      return M[0]*d[0]*d[0] + 2*M[1]*d[0]*d[1] + M[2]*d[1]*d[1];
+    return M[0]*d[0]*d[0] + M[3]*d[1]*d[1] + M[5]*d[2]*d[2]
+      + 2 * (M[1]*d[0]*d[1] + M[2]*d[0]*d[2] + M[4]*d[1]*d[2]);
+  }
+
+  inline double
+  metric_det (int dim, const double *M)
+  {
+    if (dim == 2)
+      return M[0]*M[2] - M[1]*M[1];
+    return M[0] * (M[3]*M[5] - M[4]*M[4]) - M[1] * (M[1]*M[5] - M[4]*M[2])
+      + M[2] * (M[1]*M[4] - M[3]*M[2]);
+  }
+
+  // Check that M is positive definite (Sylvester's criterion).
+  inline bool
+  metric_valid (int dim, const double *M)
+  {
+    if (dim == 2)
+      return M[0] > 0 && metric_det (2, M) > 0;
+    return M[0] > 0 && M[0]*M[3] - M[1]*M[1] > 0 && metric_det (3, M) > 0;
+  }
+
+  struct remesh_options
+  {
+    int maxiter;     // maximum number of split/collapse/swap/smooth rounds
+    int smooth;      // smoothing passes per round
+    double lmin;     // edges shorter than this in the metric are collapsed
+    double lmax;     // edges longer than this in the metric are split
+    double qmin;     // quality that a collapse may not go below,
+                     // unless the elements around were worse
+
+    remesh_options (void)
+      : maxiter (20), smooth (2), lmin (std::sqrt (0.5)),
+        lmax (std::sqrt (2.0)), qmin (0.3)
+    { }
+  };
+
+  struct remesh_stats
+  {
+    index_t splits, collapses, swaps, moves;
+    int iterations;
+  };
+
+  class remesher
+  {
+  public:
+
+    // The working copy of the mesh, in the same layout as the Octave
+    // fields, with 1-based connectivity and columns whose first entry
+    // is 0 marking deleted elements.
+    int dim;
+    index_t erows, trows;
+    std::vector<double> p, metric, e, t;
+
+    remesher (int dim_arg, index_t erows_arg, index_t trows_arg)
+      : dim (dim_arg), erows (erows_arg), trows (trows_arg)
+    { }
+
+    remesh_stats
+    run (const remesh_options& opt_arg)
+    {
+      opt = opt_arg;
+      alive.assign (num_points (), 1);
+      remesh_stats st = {0, 0, 0, 0, 0};
+      for (st.iterations = 0; st.iterations < opt.maxiter; )
+        {
+          ++st.iterations;
+          const index_t ns = split_pass ();
+          const index_t nc = collapse_pass ();
+          const index_t nw = dim == 2 ? swap_pass () : 0;
+          for (int k = 0; k < opt.smooth; ++k)
+            st.moves += smooth_pass ();
+          st.splits += ns;
+          st.collapses += nc;
+          st.swaps += nw;
+          if (ns + nc + nw == 0)
+            break;
+        }
+      remove_dead_points ();
+      return st;
+    }
+
+  private:
+
+    remesh_options opt;
+    std::vector<char> alive;
+    mesh_view<double> m;
+    std::vector<index_t> v2t_ptr, v2t, v2e_ptr, v2e;
+
+    // Node classification: 0 = free, 1 = on a single straight or curved
+    // feature line (2D only), 2 = fixed.  fnb holds the two neighbours
+    // of the nodes of kind 1 along the feature line.
+    std::vector<char> kind;
+    std::vector<index_t> fnb;
+    facet_table ft;
+    std::vector<index_t> efacet;
+
+    index_t num_points (void) const { return p.size () / dim; }
+    index_t num_cells (void) const { return t.size () / trows; }
+    index_t num_facets (void) const { return e.size () / erows; }
+
+    const double *pt (index_t i) const { return &p[dim * i]; }
+    const double *mt (index_t i) const
+    { return &metric[metric_size (dim) * i]; }
+
+    index_t cv (int k, index_t j) const
+    { return static_cast<index_t> (t[k + trows * j]) - 1; }
+
+    bool
+    cell_has (index_t j, index_t a) const
+    {
+      for (int k = 0; k <= dim; ++k)
+        if (cv (k, j) == a)
+          return true;
+      return false;
+    }
+
+    static void
+    replace (double *col, int nv, index_t from, index_t to)
+    {
+      for (int k = 0; k < nv; ++k)
+        if (col[k] == from + 1)
+          col[k] = to + 1;
+    }
+
+    // Refresh the view and the vertex to element and vertex to facet
+    // incidences after the mesh has changed.
+    void
+    update (void)
+    {
+      m.dim = dim;
+      m.np = num_points ();
+      m.ne = num_facets ();
+      m.nt = num_cells ();
+      m.p = p.data ();
+      m.e = e.data ();
+      m.t = t.data ();
+      m.erows = erows;
+      m.trows = trows;
+      m.set_inline_tags ();
+      build_incidence (m.t, trows, dim + 1, m.nt, m.np, v2t_ptr, v2t);
+      build_incidence (m.e, erows, dim, m.ne, m.np, v2e_ptr, v2e);
+    }
+
+    // Label of a feature facet, used to tell corners from points lying
+    // inside a feature line.
+    struct feature_label
+    {
+      int kind;
+      double a, b;
+      bool operator == (const feature_label& o) const
+      { return kind == o.kind && a == o.a && b == o.b; }
+    };
+
+    feature_label
+    facet_label (index_t f) const
+    {
+      feature_label l;
+      if (efacet[f] >= 0)
+        {
+          l.kind = 0;
+          l.a = erows > 4 ? e[4 + erows * efacet[f]] : 0;
+          l.b = 0;
+        }
+      else
+        {
+          const double r0 = m.region (ft.cell[2*f]);
+          const double r1 = ft.count[f] > 1 ? m.region (ft.cell[2*f+1]) : r0;
+          l.kind = ft.count[f] > 1 ? 1 : 2;
+          l.a = std::min (r0, r1);
+          l.b = std::max (r0, r1);
+        }
+      return l;
+    }
+
+    bool
+    is_feature (index_t f) const
+    {
+      return ft.count[f] != 2 || efacet[f] >= 0
+        || m.region (ft.cell[2*f]) != m.region (ft.cell[2*f+1]);
+    }
+
+    void
+    classify (void)
+    {
+      const index_t np = m.np;
+      build_facet_table (m, ft);
+      const index_t nf = ft.num_facets ();
+
+      kind.assign (np, 0);
+      fnb.assign (2 * np, -1);
+      efacet.assign (nf, -1);
+      for (index_t j = 0; j < m.ne; ++j)
+        {
+          index_t v[3];
+          for (int k = 0; k < dim; ++k)
+            v[k] = m.ev (k, j);
+          const index_t f = ft.find (v);
+          if (f < 0)
+            for (int k = 0; k < dim; ++k)
+              kind[v[k]] = 2;
+          else if (efacet[f] < 0)
+            efacet[f] = j;
+        }
+
+      std::vector<int> nfe (np, 0);
+      std::vector<feature_label> lab (np);
+      for (index_t f = 0; f < nf; ++f)
+        if (is_feature (f))
+          {
+            const index_t *v = &ft.verts[dim * f];
+            if (dim == 3)
+              {
+                for (int k = 0; k < 3; ++k)
+                  kind[v[k]] = 2;
+                continue;
+              }
+            const feature_label l = facet_label (f);
+            for (int k = 0; k < 2; ++k)
+              {
+                const index_t a = v[k];
+                if (nfe[a] == 0)
+                  lab[a] = l;
+                else if (! (lab[a] == l))
+                  kind[a] = 2;
+                if (nfe[a] < 2)
+                  fnb[2*a + nfe[a]] = v[1-k];
+                ++nfe[a];
+              }
+          }
+
+      if (dim == 2)
+        for (index_t a = 0; a < np; ++a)
+          if (nfe[a] > 0 && kind[a] == 0)
+            kind[a] = nfe[a] == 2 ? 1 : 2;
+    }
+
+    // Length of the edge (a,b) in the metric, averaged between the
+    // metrics at the two ends.
+    double
+    length (index_t a, index_t b) const
+    {
+      double d[3];
+      for (int i = 0; i < dim; ++i)
+        d[i] = pt (b)[i] - pt (a)[i];
+      return 0.5 * (std::sqrt (metric_dot (dim, mt (a), d))
+                    + std::sqrt (metric_dot (dim, mt (b), d)));
+    }
+
+    // Mean ratio of the simplex with vertices x, measured in the
+    // average of the metrics at the nodes v; it is 1 for a simplex that
+    // is equilateral in the metric.  The signed volume factor is
+    // returned in det.
+    double
+    quality (const index_t *v, const double *const *x, double& det) const
+    {
+      const int ms = metric_size (dim);
+      double M[6] = {0, 0, 0, 0, 0, 0};
+      for (int k = 0; k <= dim; ++k)
+        for (int i = 0; i < ms; ++i)
+          M[i] += mt (v[k])[i] / (dim + 1);
+
+      double u[3][3];
+      for (int k = 1; k <= dim; ++k)
+        for (int i = 0; i < dim; ++i)
+          u[k-1][i] = x[k][i] - x[0][i];
+      if (dim == 2)
+        det = u[0][0] * u[1][1] - u[0][1] * u[1][0];
+      else
+        det = u[0][0] * (u[1][1] * u[2][2] - u[1][2] * u[2][1])
+          - u[0][1] * (u[1][0] * u[2][2] - u[1][2] * u[2][0])
+          + u[0][2] * (u[1][0] * u[2][1] - u[1][1] * u[2][0]);
+
+      double l2 = 0;
+      for (int k = 0; k < num_local_edges (dim); ++k)
+        {
+          const int *le = local_edge (dim, k);
+          double d[3];
+          for (int i = 0; i < dim; ++i)
+            d[i] = x[le[1]][i] - x[le[0]][i];
+          l2 += metric_dot (dim, M, d);
+        }
+      if (l2 <= 0)
+        return 0;
+
+      const double vol = std::abs (det) * std::sqrt (metric_det (dim, M));
+      if (dim == 2)
+        return 2 * std::sqrt (3.0) * vol / l2;
+      return 12 * std::pow (vol / 2, 2.0 / 3.0) / l2;
+    }
+
+    double
+    cell_quality (index_t j, double& det) const
+    {
+      index_t v[4] = {0, 0, 0, 0};
+      const double *x[4] = {0, 0, 0, 0};
+      for (int k = 0; k <= dim; ++k)
+        {
+          v[k] = cv (k, j);
+          x[k] = pt (v[k]);
+        }
+      return quality (v, x, det);
+    }
+
+    static void
+    intersect (const index_t *a0, const index_t *a1, const index_t *b0,
+               const index_t *b1, std::vector<index_t>& out)
+    {
+      out.clear ();
+      std::set_intersection (a0, a1, b0, b1, std::back_inserter (out));
+    }
+
+    // Elements around the edge (a,b).
+    void
+    shell (index_t a, index_t b, std::vector<index_t>& out) const
+    {
+      intersect (&v2t[0] + v2t_ptr[a], &v2t[0] + v2t_ptr[a+1],
+                 &v2t[0] + v2t_ptr[b], &v2t[0] + v2t_ptr[b+1], out);
+    }
+
+    // Columns of e containing both a and b.
+    void
+    facets_of_edge (index_t a, index_t b, std::vector<index_t>& out) const
+    {
+      out.clear ();
+      if (v2e.empty ())
+        return;
+      intersect (&v2e[0] + v2e_ptr[a], &v2e[0] + v2e_ptr[a+1],
+                 &v2e[0] + v2e_ptr[b], &v2e[0] + v2e_ptr[b+1], out);
+    }
+
+    // Elements containing a or b.
+    void
+    ball2 (index_t a, index_t b, std::vector<index_t>& out) const
+    {
+      out.clear ();
+      std::set_union (&v2t[0] + v2t_ptr[a], &v2t[0] + v2t_ptr[a+1],
+                      &v2t[0] + v2t_ptr[b], &v2t[0] + v2t_ptr[b+1],
+                      std::back_inserter (out));
+    }
+
+    // Vertices of the elements in cells, other than a and b.
+    void
+    vertices_of (const std::vector<index_t>& cells, index_t a, index_t b,
+                 std::vector<index_t>& out) const
+    {
+      out.clear ();
+      for (size_t c = 0; c < cells.size (); ++c)
+        for (int k = 0; k <= dim; ++k)
+          {
+            const index_t v = cv (k, cells[c]);
+            if (v != a && v != b)
+              out.push_back (v);
+          }
+      std::sort (out.begin (), out.end ());
+      out.erase (std::unique (out.begin (), out.end ()), out.end ());
+    }
+
+    void
+    neighbours (index_t a, std::vector<index_t>& out) const
+    {
+      std::vector<index_t> cells (&v2t[0] + v2t_ptr[a],
+                                  &v2t[0] + v2t_ptr[a+1]);
+      vertices_of (cells, a, a, out);
+    }
+
+    // Keep the candidates, listed by decreasing priority, that do not
+    // share any element with a candidate of higher priority: each
+    // element is claimed by the first candidate locking it, and a
+    // candidate is selected if it owns all the elements it locks.
+    std::vector<char>
+    select (const std::vector<std::vector<index_t> >& locks) const
+    {
+      const index_t nc = locks.size (), nt = num_cells ();
+      std::vector<std::atomic<index_t> > owner (nt);
+#pragma omp parallel for
+      for (index_t j = 0; j < nt; ++j)
+        owner[j].store (nc);
+
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t c = 0; c < nc; ++c)
+        for (size_t k = 0; k < locks[c].size (); ++k)
+          {
+            std::atomic<index_t>& o = owner[locks[c][k]];
+            index_t cur = o.load ();
+            while (c < cur && ! o.compare_exchange_weak (cur, c))
+              ;
+          }
+
+      std::vector<char> ok (nc, 1);
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t c = 0; c < nc; ++c)
+        for (size_t k = 0; k < locks[c].size (); ++k)
+          if (owner[locks[c][k]].load () != c)
+            {
+              ok[c] = 0;
+              break;
+            }
+      return ok;
+    }
+
+    // Drop the columns marked as deleted.
+    static void
+    compact_columns (std::vector<double>& a, index_t rows)
+    {
+      const index_t n = a.size () / rows;
+      index_t k = 0;
+      for (index_t j = 0; j < n; ++j)
+        if (a[rows * j] != 0)
+          {
+            if (k != j)
+              std::copy (&a[rows * j], &a[rows * j] + rows, &a[rows * k]);
+            ++k;
+          }
+      a.resize (rows * k);
+    }
+
+    // Sort candidates by increasing key, ties broken by index, so that
+    // the selection is reproducible.
+    static void
+    sort_candidates (std::vector<index_t>& cand, const std::vector<double>& key)
+    {
+      std::sort (cand.begin (), cand.end (),
+                 [&key] (index_t x, index_t y)
+                 { return key[x] < key[y] || (key[x] == key[y] && x < y); });
+    }
+
+    // Split the edges longer than lmax at their midpoint.
+    index_t
+    split_pass (void)
+    {
+      update ();
+      edge_table et;
+      build_edge_table (m, et);
+      const index_t ned = et.num_edges ();
+
+      std::vector<double> key (ned);
+#pragma omp parallel for
+      for (index_t i = 0; i < ned; ++i)
+        key[i] = - length (et.lo (i), et.hi[i]);
+      std::vector<index_t> cand;
+      for (index_t i = 0; i < ned; ++i)
+        if (- key[i] > opt.lmax)
+          cand.push_back (i);
+      sort_candidates (cand, key);
+
+      const index_t nc = cand.size ();
+      std::vector<std::vector<index_t> > locks (nc);
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t c = 0; c < nc; ++c)
+        shell (et.lo (cand[c]), et.hi[cand[c]], locks[c]);
+      const std::vector<char> ok = select (locks);
+
+      std::vector<index_t> acc;
+      for (index_t c = 0; c < nc; ++c)
+        if (ok[c])
+          acc.push_back (c);
+      const index_t na = acc.size ();
+      if (na == 0)
+        return 0;
+
+      std::vector<index_t> toff (na + 1), eoff (na + 1);
+      std::vector<std::vector<index_t> > efac (na);
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t i = 0; i < na; ++i)
+        {
+          const index_t ed = cand[acc[i]];
+          facets_of_edge (et.lo (ed), et.hi[ed], efac[i]);
+          toff[i] = locks[acc[i]].size ();
+          eoff[i] = efac[i].size ();
+        }
+      toff[na] = eoff[na] = 0;
+      const index_t nnt = prefix_sum (toff), nne = prefix_sum (eoff);
+
+      const index_t np0 = m.np, nt0 = m.nt, ne0 = m.ne;
+      const int ms = metric_size (dim);
+      p.resize (dim * (np0 + na));
+      metric.resize (ms * (np0 + na));
+      t.resize (trows * (nt0 + nnt));
+      e.resize (erows * (ne0 + nne));
+      alive.resize (np0 + na, 1);
+
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t i = 0; i < na; ++i)
+        {
+          const index_t ed = cand[acc[i]];
+          const index_t a = et.lo (ed), b = et.hi[ed], n = np0 + i;
+          for (int k = 0; k < dim; ++k)
+            p[dim * n + k] = 0.5 * (p[dim * a + k] + p[dim * b + k]);
+          for (int k = 0; k < ms; ++k)
+            metric[ms * n + k] = 0.5 * (metric[ms * a + k]
+                                        + metric[ms * b + k]);
+
+          const std::vector<index_t>& sh = locks[acc[i]];
+          for (size_t s = 0; s < sh.size (); ++s)
+            {
+              double *col = &t[trows * sh[s]];
+              double *ncol = &t[trows * (nt0 + toff[i] + s)];
+              std::copy (col, col + trows, ncol);
+              replace (col, dim + 1, b, n);
+              replace (ncol, dim + 1, a, n);
+            }
+          for (size_t s = 0; s < efac[i].size (); ++s)
+            {
+              double *col = &e[erows * efac[i][s]];
+              double *ncol = &e[erows * (ne0 + eoff[i] + s)];
+              std::copy (col, col + erows, ncol);
+              replace (col, dim, b, n);
+              replace (ncol, dim, a, n);
+            }
+        }
+      return na;
+    }
+
+    // Whether the node a can be merged into b, keeping the mesh valid
+    // and its features in place.
+    bool
+    can_collapse (index_t a, index_t b) const
+    {
+      if (kind[a] == 2)
+        return false;
+      if (kind[a] == 1)
+        {
+          // Slide a onto b along a straight feature line.
+          if (fnb[2*a] != b && fnb[2*a+1] != b)
+            return false;
+          const index_t c = fnb[2*a] == b ? fnb[2*a+1] : fnb[2*a];
+          const double u0 = pt (b)[0] - pt (a)[0], u1 = pt (b)[1] - pt (a)[1];
+          const double w0 = pt (c)[0] - pt (a)[0], w1 = pt (c)[1] - pt (a)[1];
+          if (u0*w0 + u1*w1 >= 0
+              || std::abs (u0*w1 - u1*w0)
+                 > feature_tol * std::sqrt ((u0*u0 + u1*u1)
+                                            * (w0*w0 + w1*w1)))
+            return false;
+        }
+
+      // Link condition: the common neighbours of a and b must be the
+      // vertices of the elements around the edge.
+      std::vector<index_t> na, nb, common, sh, link;
+      neighbours (a, na);
+      neighbours (b, nb);
+      intersect (na.data (), na.data () + na.size (), nb.data (),
+                 nb.data () + nb.size (), common);
+      shell (a, b, sh);
+      vertices_of (sh, a, b, link);
+      if (common != link)
+        return false;
+
+      double qold = 1, qnew = 1;
+      for (index_t s = v2t_ptr[a]; s < v2t_ptr[a+1]; ++s)
+        {
+          const index_t j = v2t[s];
+          double det, ndet;
+          qold = std::min (qold, cell_quality (j, det));
+          if (cell_has (j, b))
+            continue;
+
+          index_t v[4];
+          const double *x[4];
+          for (int k = 0; k <= dim; ++k)
+            {
+              v[k] = cv (k, j);
+              if (v[k] == a)
+                v[k] = b;
+              else if (length (b, v[k]) > opt.lmax)
+                return false;
+              x[k] = pt (v[k]);
+            }
+          qnew = std::min (qnew, quality (v, x, ndet));
+          if (! (ndet * det > 0))
+            return false;
+        }
+      return qnew >= std::min (opt.qmin, qold);
+    }
+
+    // Merge one end of the edges shorter than lmin into the other.
+    index_t
+    collapse_pass (void)
+    {
+      update ();
+      classify ();
+      edge_table et;
+      build_edge_table (m, et);
+      const index_t ned = et.num_edges ();
+
+      std::vector<double> key (ned);
+#pragma omp parallel for
+      for (index_t i = 0; i < ned; ++i)
+        key[i] = length (et.lo (i), et.hi[i]);
+      std::vector<index_t> short_edges;
+      for (index_t i = 0; i < ned; ++i)
+        if (key[i] < opt.lmin)
+          short_edges.push_back (i);
+      sort_candidates (short_edges, key);
+
+      // Remove the node of lower kind first.
+      const index_t ns = short_edges.size ();
+      std::vector<index_t> from (ns, -1), to (ns, -1);
+#pragma omp parallel for schedule (dynamic, 64)
+      for (index_t c = 0; c < ns; ++c)
+        {
+          index_t a = et.lo (short_edges[c]), b = et.hi[short_edges[c]];
+          if (kind[b] < kind[a])
+            std::swap (a, b);
+          if (alive[a] && can_collapse (a, b))
+            from[c] = a, to[c] = b;
+          else if (alive[b] && can_collapse (b, a))
+            from[c] = b, to[c] = a;
+        }
+
+      std::vector<index_t> cand;
+      for (index_t c = 0; c < ns; ++c)
+        if (from[c] >= 0)
+          cand.push_back (c);
+      const index_t nc = cand.size ();
+      std::vector<std::vector<index_t> > locks (nc);
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t c = 0; c < nc; ++c)
+        ball2 (from[cand[c]], to[cand[c]], locks[c]);
+      const std::vector<char> ok = select (locks);
+
+      index_t na = 0;
+#pragma omp parallel for schedule (dynamic, 256) reduction (+:na)
+      for (index_t c = 0; c < nc; ++c)
+        if (ok[c])
+          {
+            const index_t a = from[cand[c]], b = to[cand[c]];
+            for (index_t s = v2t_ptr[a]; s < v2t_ptr[a+1]; ++s)
+              {
+                double *col = &t[trows * v2t[s]];
+                if (cell_has (v2t[s], b))
+                  col[0] = 0;
+                else
+                  replace (col, dim + 1, a, b);
+              }
+            for (index_t s = v2e_ptr[a]; s < v2e_ptr[a+1]; ++s)
+              {
+                double *col = &e[erows * v2e[s]];
+                bool has_b = false;
+                for (int k = 0; k < dim; ++k)
+                  has_b = has_b || col[k] == b + 1;
+                if (has_b)
+                  col[0] = 0;
+                else
+                  replace (col, dim, a, b);
+              }
+            alive[a] = 0;
+            ++na;
+          }
+
+      compact_columns (t, trows);
+      compact_columns (e, erows);
+      return na;
+    }
+
+    // Swap the interior edges of 2D meshes whose swap improves the
+    // quality of the two triangles around them.
+    index_t
+    swap_pass (void)
+    {
+      update ();
+      classify ();
+      const index_t nf = ft.num_facets ();
+
+      std::vector<double> key (nf, 0);
+      std::vector<index_t> cand;
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t f = 0; f < nf; ++f)
+        if (! is_feature (f))
+          key[f] = - swap_gain (f);
+      for (index_t f = 0; f < nf; ++f)
+        if (key[f] < 0)
+          cand.push_back (f);
+      sort_candidates (cand, key);
+
+      const index_t nc = cand.size ();
+      std::vector<std::vector<index_t> > locks (nc);
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t c = 0; c < nc; ++c)
+        {
+          index_t cc, dd;
+          int k1, k2;
+          swap_vertices (cand[c], cc, dd, k1, k2);
+          ball2 (cc, dd, locks[c]);
+        }
+      const std::vector<char> ok = select (locks);
+
+      index_t na = 0;
+#pragma omp parallel for schedule (dynamic, 256) reduction (+:na)
+      for (index_t c = 0; c < nc; ++c)
+        if (ok[c])
+          {
+            const index_t f = cand[c];
+            index_t cc, dd;
+            int k1, k2;
+            swap_vertices (f, cc, dd, k1, k2);
+            const index_t t1 = ft.cell[2*f], t2 = ft.cell[2*f+1];
+            const index_t v = cv ((k1 + 2) % 3, t1);
+            t[trows * t1 + (k1 + 2) % 3] = dd + 1;
+            t[trows * t2 + 0] = dd + 1;
+            t[trows * t2 + 1] = v + 1;
+            t[trows * t2 + 2] = cc + 1;
+            ++na;
+          }
+      return na;
+    }
+
+    // Vertices opposite to the edge f in its two triangles, and their
+    // local numbers.
+    void
+    swap_vertices (index_t f, index_t& c, index_t& d, int& k1, int& k2) const
+    {
+      const index_t t1 = ft.cell[2*f], t2 = ft.cell[2*f+1];
+      const index_t a = ft.verts[2*f], b = ft.verts[2*f+1];
+      for (k1 = 0; k1 < 3; ++k1)
+        if (cv (k1, t1) != a && cv (k1, t1) != b)
+          break;
+      for (k2 = 0; k2 < 3; ++k2)
+        if (cv (k2, t2) != a && cv (k2, t2) != b)
+          break;
+      c = cv (k1, t1);
+      d = cv (k2, t2);
+    }
+
+    // Improvement of the minimum quality obtained by swapping the edge
+    // f, or 0 if the swap is not possible.
+    double
+    swap_gain (index_t f) const
+    {
+      const index_t t1 = ft.cell[2*f], t2 = ft.cell[2*f+1];
+      index_t c, d;
+      int k1, k2;
+      swap_vertices (f, c, d, k1, k2);
+
+      double det1, det2;
+      const double qold = std::min (cell_quality (t1, det1),
+                                    cell_quality (t2, det2));
+      if (! (det1 * det2 > 0))
+        return 0;
+
+      // After the swap the triangles are (c, u, d) and (d, v, c), with
+      // (c, u, v) the vertices of t1 in their order.
+      const index_t u = cv ((k1 + 1) % 3, t1), v = cv ((k1 + 2) % 3, t1);
+      const index_t n1[3] = {c, u, d}, n2[3] = {d, v, c};
+      const double *x1[3] = {pt (c), pt (u), pt (d)};
+      const double *x2[3] = {pt (d), pt (v), pt (c)};
+      double ndet1, ndet2;
+      const double qnew = std::min (quality (n1, x1, ndet1),
+                                    quality (n2, x2, ndet2));
+      if (! (ndet1 * det1 > 0 && ndet2 * det1 > 0))
+        return 0;
+      if (qnew <= qold * (1 + swap_tol))
+        return 0;
+
+      // Do not create an edge that is already there.
+      std::vector<index_t> nc;
+      neighbours (c, nc);
+      if (std::binary_search (nc.begin (), nc.end (), d))
+        return 0;
+      return qnew - qold;
+    }
+
+    // Move the free nodes towards the centroid of their neighbours when
+    // this improves the quality of the elements around them.
+    index_t
+    smooth_pass (void)
+    {
+      update ();
+      classify ();
+      const index_t np = m.np;
+
+      std::vector<double> key (np, 0), target (dim * np);
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t a = 0; a < np; ++a)
+        if (alive[a] && kind[a] == 0 && v2t_ptr[a+1] > v2t_ptr[a])
+          key[a] = - smooth_gain (a, &target[dim * a]);
+
+      std::vector<index_t> cand;
+      for (index_t a = 0; a < np; ++a)
+        if (key[a] < 0)
+          cand.push_back (a);
+      sort_candidates (cand, key);
+
+      const index_t nc = cand.size ();
+      std::vector<std::vector<index_t> > locks (nc);
+#pragma omp parallel for schedule (dynamic, 256)
+      for (index_t c = 0; c < nc; ++c)
+        locks[c].assign (&v2t[0] + v2t_ptr[cand[c]],
+                         &v2t[0] + v2t_ptr[cand[c]+1]);
+      const std::vector<char> ok = select (locks);
+
+      index_t na = 0;
+#pragma omp parallel for reduction (+:na)
+      for (index_t c = 0; c < nc; ++c)
+        if (ok[c])
+          {
+            const index_t a = cand[c];
+            std::copy (&target[dim * a], &target[dim * a] + dim, &p[dim * a]);
+            ++na;
+          }
+      return na;
+    }
+
+    double
+    smooth_gain (index_t a, double *x) const
+    {
+      std::vector<index_t> nb;
+      neighbours (a, nb);
+      for (int i = 0; i < dim; ++i)
+        {
+          x[i] = 0;
+          for (size_t k = 0; k < nb.size (); ++k)
+            x[i] += pt (nb[k])[i] / nb.size ();
+        }
+
+      double qold = 1, qnew = 1;
+      for (index_t s = v2t_ptr[a]; s < v2t_ptr[a+1]; ++s)
+        {
+          const index_t j = v2t[s];
+          index_t v[4];
+          const double *xo[4], *xn[4];
+          for (int k = 0; k <= dim; ++k)
+            {
+              v[k] = cv (k, j);
+              xo[k] = pt (v[k]);
+              xn[k] = v[k] == a ? x : xo[k];
+            }
+          double det, ndet;
+          qold = std::min (qold, quality (v, xo, det));
+          qnew = std::min (qnew, quality (v, xn, ndet));
+          if (! (ndet * det > 0))
+            return 0;
+        }
+      return qnew > qold * (1 + swap_tol) ? qnew - qold : 0;
+    }
+
+    // Renumber the nodes, dropping the ones removed by collapses.
+    void
+    remove_dead_points (void)
+    {
+      const index_t np = num_points ();
+      const int ms = metric_size (dim);
+      std::vector<index_t> id (np + 1);
+      for (index_t i = 0; i < np; ++i)
+        id[i] = alive[i] ? 1 : 0;
+      id[np] = 0;
+      const index_t nn = prefix_sum (id);
+      for (index_t i = 0; i < np; ++i)
+        if (alive[i])
+          {
+            std::copy (&p[dim * i], &p[dim * i] + dim, &p[dim * id[i]]);
+            std::copy (&metric[ms * i], &metric[ms * i] + ms,
+                       &metric[ms * id[i]]);
+          }
+      p.resize (dim * nn);
+      metric.resize (ms * nn);
+
+      const index_t nt = num_cells (), ne = num_facets ();
+#pragma omp parallel for
+      for (index_t j = 0; j < nt; ++j)
+        for (int k = 0; k <= dim; ++k)
+          t[k + trows * j] = id[cv (k, j)] + 1;
+#pragma omp parallel for
+      for (index_t j = 0; j < ne; ++j)
+        for (int k = 0; k < dim; ++k)
+          e[k + erows * j] = id[static_cast<index_t> (e[k + erows * j]) - 1] + 1;
+      alive.assign (nn, 1);
+    }
+
+    // Sine of the largest angle between two feature edges for which
+    // their common node may still be removed, and relative quality gain
+    // below which swaps and moves are not worth doing.
+    static constexpr double feature_tol = 1e-3;
+    static constexpr double swap_tol = 1e-3;
+  };
+}
+
+#endif
@@ -0,0 +1,356 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Implicit structured meshes.
+//
+// The meshes built by msh2m_structured_mesh and msh3m_structured_mesh
+// are determined by the grid vectors x, y, z and by the way each cell
+// is split into simplices.  structured_grid computes the coordinates
+// of a node, the vertices of an element and the vertices and label of
+// a boundary facet from their number by index arithmetic, with the
+// same numbering as the explicit meshes, so that a grid can be queried
+// or have its element properties computed without building p, e and t.
+// The splitting pattern is a template parameter, so that the offsets
+// are compile time constants in the inner loops.
+
+#if ! defined (MSH_STRUCTURED_H)
+#define MSH_STRUCTURED_H 1
+
+#include "msh_kernels.h"
+
+namespace msh
+{
+  // Splitting of the cells: the "right" and "left" diagonal of
+  // msh2m_structured_mesh and the six tetrahedra of
+  // msh3m_structured_mesh.
+  enum grid_pattern { grid_right, grid_left, grid_kuhn };
+
+  // Vertex offsets (di, dj, dk) of the simplices in a cell, with i, j,
+  // k running along x, y and z.
+  template <int P> struct pattern_traits;
+
+  template <>
+  struct pattern_traits<grid_right>
+  {
+    static const int dim = 2, ncell = 2;
+    static const int (*offsets (void))[3][3]
+    {
+      static const int o[2][3][3] =
+        {{{0,0,0}, {1,0,0}, {1,1,0}}, {{0,0,0}, {1,1,0}, {0,1,0}}};
+      return o;
+    }
+  };
+
+  template <>
+  struct pattern_traits<grid_left>
+  {
+    static const int dim = 2, ncell = 2;
+    static const int (*offsets (void))[3][3]
+    {
+      static const int o[2][3][3] =
+        {{{0,0,0}, {1,0,0}, {0,1,0}}, {{0,1,0}, {1,0,0}, {1,1,0}}};
+      return o;
+    }
+  };
+
+  template <>
+  struct pattern_traits<grid_kuhn>
+  {
+    static const int dim = 3, ncell = 6;
+    static const int (*offsets (void))[4][3]
+    { return kuhn_offsets; }
+  };
+
+  template <int P>
+  class structured_grid
+  {
+  public:
+
+    typedef pattern_traits<P> traits;
+    static const int dim = traits::dim, nv = dim + 1;
+
+    // x, y, z must be sorted and outlive the grid; z is ignored in 2D.
+    structured_grid (const double *x, index_t nx, const double *y,
+                     index_t ny, const double *z, index_t nz,
+                     double region, const double *sides)
+      : region (region)
+    {
+      const double *v[3] = {x, y, z};
+      const index_t n[3] = {nx, ny, dim == 3 ? nz : 1};
+      for (int a = 0; a < 3; ++a)
+        {
+          coord[a] = v[a];
+          nn[a] = n[a];
+          nc[a] = dim == 3 || a < 2 ? n[a] - 1 : 1;
+        }
+      for (int s = 0; s < 2 * dim; ++s)
+        side[s] = sides[s];
+
+      const structured_size sz = dim == 2 ? structured_mesh_size (nx, ny)
+                                          : structured_mesh_size (nx, ny, nz);
+      np = sz.np;
+      ne = sz.ne;
+      nt = sz.nt;
+      ncells = nc[0] * nc[1] * nc[2];
+
+      // First facet of each side, in the order of e.
+      side_start[0] = 0;
+      for (int s = 0; s < 2 * dim; ++s)
+        {
+          const int axis = side_axis (s);
+          index_t cells = 1;
+          for (int a = 0; a < dim; ++a)
+            if (a != axis)
+              cells *= nc[a];
+          side_start[s+1] = side_start[s] + (dim == 2 ? 1 : 2) * cells;
+        }
+
+      if (dim == 3)
+        init_faces ();
+    }
+
+    index_t num_points (void) const { return np; }
+    index_t num_facets (void) const { return ne; }
+    index_t num_elements (void) const { return nt; }
+    double element_region (void) const { return region; }
+
+    // Node number of grid point (i, j, k).
+    index_t
+    node (index_t i, index_t j, index_t k) const
+    { return j + nn[1] * (i + nn[0] * k); }
+
+    void
+    point (index_t n, double *c) const
+    {
+      const index_t j = n % nn[1], ik = n / nn[1];
+      c[0] = coord[0][ik % nn[0]];
+      c[1] = coord[1][j];
+      if (dim == 3)
+        c[2] = coord[2][ik / nn[0]];
+    }
+
+    // 0-based vertices of element t, which is simplex t / ncells of cell
+    // t % ncells, the cells being numbered along y, then x, then z.
+    void
+    element (index_t t, index_t *v) const
+    {
+      const int b = t / ncells;
+      const index_t c = t % ncells;
+      const index_t j = c % nc[1], ik = c / nc[1];
+      const index_t i = ik % nc[0], k = ik / nc[0];
+      for (int q = 0; q < nv; ++q)
+        {
+          const int *o = traits::offsets ()[b][q];
+          v[q] = node (i + o[0], j + o[1], k + o[2]);
+        }
+    }
+
+    // 0-based vertices of boundary facet f and its label.
+    void
+    facet (index_t f, index_t *v, double& label) const
+    {
+      int s = 0;
+      while (f >= side_start[s+1])
+        ++s;
+      label = side[s];
+      index_t q = f - side_start[s];
+
+      if (dim == 2)
+        {
+          // Bottom, right, top, left, with increasing node numbers.
+          switch (s)
+            {
+            case 0:
+              v[0] = node (q, 0, 0);
+              v[1] = node (q + 1, 0, 0);
+              break;
+            case 1:
+              v[0] = node (nc[0], q, 0);
+              v[1] = node (nc[0], q + 1, 0);
+              break;
+            case 2:
+              v[0] = node (q, nc[1], 0);
+              v[1] = node (q + 1, nc[1], 0);
+              break;
+            default:
+              v[0] = node (0, q, 0);
+              v[1] = node (0, q + 1, 0);
+            }
+          return;
+        }
+
+      // Two triangles per cell face, listed by simplex and then by cell
+      // along y, x and z skipping the axis normal to the side.
+      const int axis = side_axis (s);
+      index_t cells = 1;
+      for (int a = 0; a < 3; ++a)
+        if (a != axis)
+          cells *= nc[a];
+      const int h = q / cells;
+      q %= cells;
+
+      static const int loop_order[3] = {1, 0, 2};
+      index_t ijk[3];
+      for (int l = 0; l < 3; ++l)
+        {
+          const int a = loop_order[l];
+          if (a == axis)
+            ijk[a] = s % 2 ? nc[a] - 1 : 0;
+          else
+            {
+              ijk[a] = q % nc[a];
+              q /= nc[a];
+            }
+        }
+
+      const int b = face_simplex[s][h];
+      for (int r = 0; r < 3; ++r)
+        {
+          const int *o = traits::offsets ()[b][face_vertex[s][h][r]];
+          v[r] = node (ijk[0] + o[0], ijk[1] + o[1], ijk[2] + o[2]);
+        }
+    }
+
+    // Fill p (dim x np), e and t in the layout of
+    // msh2m_structured_mesh and msh3m_structured_mesh.
+    void
+    materialize (double *p, double *e, double *t) const
+    {
+      const index_t erows = dim == 2 ? 7 : 10, trows = dim + 2;
+#pragma omp parallel for
+      for (index_t n = 0; n < np; ++n)
+        point (n, p + dim * n);
+
+#pragma omp parallel for
+      for (index_t j = 0; j < nt; ++j)
+        {
+          index_t v[nv];
+          element (j, v);
+          for (int q = 0; q < nv; ++q)
+            t[q + trows * j] = v[q] + 1;
+          t[nv + trows * j] = region;
+        }
+
+#pragma omp parallel for
+      for (index_t f = 0; f < ne; ++f)
+        {
+          index_t v[dim];
+          double label;
+          facet (f, v, label);
+          double *ef = e + erows * f;
+          std::fill (ef, ef + erows, 0.0);
+          for (int q = 0; q < dim; ++q)
+            ef[q] = v[q] + 1;
+          if (dim == 2)
+            {
+              ef[4] = label;
+              ef[6] = region;
+            }
+          else
+            {
+              ef[8] = region;
+              ef[9] = label;
+            }
+        }
+    }
+
+  private:
+
+    const double *coord[3];
+    index_t nn[3], nc[3], ncells, np, ne, nt;
+    index_t side_start[7];
+    double side[6], region;
+    // For each side of a 3D grid, the two simplices of a cell having a
+    // face on it and the positions of the face vertices among theirs.
+    int face_simplex[6][2], face_vertex[6][2][3];
+
+    static int
+    side_axis (int s)
+    {
+      // 2D sides are bottom, right, top, left; 3D sides come in pairs
+      // normal to x, y and z.
+      if (dim == 2)
+        return s % 2 ? 0 : 1;
+      return s / 2;
+    }
+
+    void
+    init_faces (void)
+    {
+      for (int s = 0; s < 6; ++s)
+        {
+          const int axis = s / 2, plane = s % 2;
+          int h = 0;
+          for (int b = 0; b < traits::ncell && h < 2; ++b)
+            {
+              int on = 0, face[4];
+              for (int q = 0; q < nv; ++q)
+                if (traits::offsets ()[b][q][axis] == plane)
+                  face[on++] = q;
+              if (on != 3)
+                continue;
+              face_simplex[s][h] = b;
+              std::copy (face, face + 3, face_vertex[s][h]);
+              ++h;
+            }
+        }
+    }
+  };
+
+  // Copy of the elements sel[0] ... sel[n-1] of a grid with their own
+  // vertices, as a mesh_view whose element q has vertices nv*q ...
+  // nv*q+nv-1, so that the element kernels written for explicit meshes
+  // can be applied to a part of the grid.
+  template <int P>
+  mesh_view<double>
+  exploded_elements (const structured_grid<P>& g, const index_t *sel,
+                     index_t n, std::vector<double>& p,
+                     std::vector<double>& t)
+  {
+    const int dim = structured_grid<P>::dim, nv = dim + 1;
+    p.resize (dim * nv * n);
+    t.resize ((nv + 1) * n);
+    for (index_t q = 0; q < n; ++q)
+      {
+        index_t v[nv];
+        g.element (sel[q], v);
+        for (int k = 0; k < nv; ++k)
+          {
+            g.point (v[k], &p[dim * (nv * q + k)]);
+            t[k + (nv + 1) * q] = nv * q + k + 1;
+          }
+        t[nv + (nv + 1) * q] = g.element_region ();
+      }
+
+    mesh_view<double> m;
+    m.dim = dim;
+    m.np = nv * n;
+    m.ne = 0;
+    m.nt = n;
+    m.p = p.data ();
+    m.e = 0;
+    m.t = t.data ();
+    m.erows = 0;
+    m.trows = nv + 1;
+    m.set_inline_tags ();
+    return m;
+  }
+}
+
+#endif
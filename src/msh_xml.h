@@ -0,0 +1,308 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Streaming access to XML files, possibly gzip compressed.
+//
+// xml_reader returns the start and end tags of a document one at a
+// time, with their attributes, skipping text, comments and processing
+// instructions; only a buffer of the file and the current tag are kept
+// in memory.  This is all that is needed for formats such as the dolfin
+// mesh format, where the data are stored in attributes.  Entities in
+// attribute values are not expanded.
+
+#if ! defined (MSH_XML_H)
+#define MSH_XML_H 1
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined (HAVE_ZLIB_H)
+#  include <zlib.h>
+#endif
+
+namespace msh
+{
+  inline bool
+  ends_with (const std::string& s, const std::string& suffix)
+  {
+    return s.size () >= suffix.size ()
+      && s.compare (s.size () - suffix.size (), suffix.size (), suffix) == 0;
+  }
+
+  // A file read or written through zlib when available, so that
+  // compressed files are handled transparently, or through stdio.
+  class stream_file
+  {
+  public:
+
+    stream_file (void) : m_fp (0), m_gz (0) { }
+
+    ~stream_file (void) { close (); }
+
+    // Open name for reading ("rb") or writing ("wb"); files written with
+    // a .gz suffix are compressed.  Return false on failure, or if the
+    // file is compressed and zlib is not available.
+    bool
+    open (const std::string& name, const char *mode)
+    {
+      close ();
+#if defined (HAVE_ZLIB_H)
+      if (mode[0] == 'r' || ends_with (name, ".gz"))
+        {
+          m_gz = gzopen (name.c_str (), mode);
+          if (m_gz)
+            gzbuffer (m_gz, 1 << 17);
+          return m_gz != 0;
+        }
+#else
+      if (ends_with (name, ".gz"))
+        return false;
+#endif
+      m_fp = std::fopen (name.c_str (), mode);
+      return m_fp != 0;
+    }
+
+    // Number of bytes read, 0 at the end of the file, -1 on error.
+    long
+    read (char *buf, std::size_t len)
+    {
+#if defined (HAVE_ZLIB_H)
+      if (m_gz)
+        return gzread (m_gz, buf, len);
+#endif
+      const std::size_t n = std::fread (buf, 1, len, m_fp);
+      return n == 0 && std::ferror (m_fp) ? -1 : long (n);
+    }
+
+    bool
+    write (const char *buf, std::size_t len)
+    {
+#if defined (HAVE_ZLIB_H)
+      if (m_gz)
+        return len == 0 || gzwrite (m_gz, buf, len) == int (len);
+#endif
+      return std::fwrite (buf, 1, len, m_fp) == len;
+    }
+
+    // Return false if the data could not be flushed.
+    bool
+    close (void)
+    {
+      bool ok = true;
+#if defined (HAVE_ZLIB_H)
+      if (m_gz)
+        ok = gzclose (m_gz) == Z_OK;
+      m_gz = 0;
+#endif
+      if (m_fp)
+        ok = std::fclose (m_fp) == 0;
+      m_fp = 0;
+      return ok;
+    }
+
+  private:
+
+    stream_file (const stream_file&);
+    stream_file& operator = (const stream_file&);
+
+    std::FILE *m_fp;
+#if defined (HAVE_ZLIB_H)
+    gzFile m_gz;
+#else
+    void *m_gz;
+#endif
+  };
+
+  class xml_reader
+  {
+  public:
+
+    enum event { start_tag, end_tag, end_of_file, syntax_error };
+
+    explicit xml_reader (stream_file& f)
+      : m_file (f), m_buf (1 << 16), m_pos (0), m_len (0), m_line (1),
+        m_pending_end (false) { }
+
+    // Advance to the next tag.  A tag like <a/> gives a start_tag
+    // followed by an end_tag.
+    event
+    next (void)
+    {
+      if (m_pending_end)
+        {
+          m_pending_end = false;
+          return end_tag;
+        }
+
+      m_attr.clear ();
+      int c;
+      for (;;)
+        {
+          while ((c = get ()) != '<')
+            if (c < 0)
+              return end_of_file;
+
+          c = get ();
+          if (c != '?' && c != '!')
+            break;
+
+          // Skip a processing instruction, comment or declaration.
+          const bool comment = c == '!' && peek () == '-';
+          int prev2 = 0, prev = 0;
+          while ((c = get ()) >= 0)
+            {
+              if (c == '>' && (! comment || (prev == '-' && prev2 == '-')))
+                break;
+              prev2 = prev;
+              prev = c;
+            }
+          if (c < 0)
+            return syntax_error;
+        }
+
+      const bool closing = c == '/';
+      if (closing)
+        c = get ();
+      m_name.clear ();
+      while (c >= 0 && ! is_space (c) && c != '>' && c != '/')
+        {
+          m_name += char (c);
+          c = get ();
+        }
+      if (m_name.empty ())
+        return syntax_error;
+
+      for (;;)
+        {
+          while (is_space (c))
+            c = get ();
+          if (c == '>')
+            return closing ? end_tag : start_tag;
+          if (c == '/')
+            {
+              if (get () != '>' || closing)
+                return syntax_error;
+              m_pending_end = true;
+              return start_tag;
+            }
+          if (c < 0 || closing)
+            return syntax_error;
+
+          std::pair<std::string, std::string> a;
+          while (c >= 0 && c != '=' && ! is_space (c))
+            {
+              a.first += char (c);
+              c = get ();
+            }
+          while (is_space (c))
+            c = get ();
+          if (c != '=')
+            return syntax_error;
+          do
+            c = get ();
+          while (is_space (c));
+          if (c != '"' && c != '\'')
+            return syntax_error;
+          const int quote = c;
+          while ((c = get ()) != quote)
+            {
+              if (c < 0)
+                return syntax_error;
+              a.second += char (c);
+            }
+          m_attr.push_back (a);
+          c = get ();
+        }
+    }
+
+    const std::string& name (void) const { return m_name; }
+
+    // Value of attribute key of the current tag, or 0.
+    const char *
+    attribute (const char *key) const
+    {
+      for (std::size_t k = 0; k < m_attr.size (); ++k)
+        if (m_attr[k].first == key)
+          return m_attr[k].second.c_str ();
+      return 0;
+    }
+
+    // Numerical value of attribute key; ok is cleared if it is missing
+    // or not a number.
+    double
+    number (const char *key, bool& ok) const
+    {
+      const char *v = attribute (key);
+      char *end = 0;
+      const double x = v ? std::strtod (v, &end) : 0;
+      if (! v || end == v || *end != '\0')
+        ok = false;
+      return x;
+    }
+
+    long line (void) const { return m_line; }
+
+  private:
+
+    static bool
+    is_space (int c)
+    { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    int
+    get (void)
+    {
+      const int c = peek ();
+      if (c >= 0)
+        {
+          ++m_pos;
+          if (c == '\n')
+            ++m_line;
+        }
+      return c;
+    }
+
+    int
+    peek (void)
+    {
+      if (m_pos == m_len)
+        {
+          const long n = m_file.read (&m_buf[0], m_buf.size ());
+          m_pos = 0;
+          m_len = n > 0 ? n : 0;
+          if (m_len == 0)
+            return -1;
+        }
+      return static_cast<unsigned char> (m_buf[m_pos]);
+    }
+
+    stream_file& m_file;
+    std::vector<char> m_buf;
+    std::size_t m_pos, m_len;
+    long m_line;
+    bool m_pending_end;
+    std::string m_name;
+    std::vector<std::pair<std::string, std::string> > m_attr;
+  };
+}
+
+#endif
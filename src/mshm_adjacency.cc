@@ -0,0 +1,182 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <string>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+// Return g as a structure with 1-based ptr and idx column vectors.
+static octave_scalar_map
+csr_struct (const msh::csr_graph& g)
+{
+  octave_scalar_map a;
+  a.setfield ("ptr", msh::one_based (g.ptr));
+  a.setfield ("idx", msh::one_based (g.idx));
+  return a;
+}
+
+// Node to node sparsity pattern, including the diagonal.  The column
+// of node i has the rows of its neighbours and i itself, in
+// increasing order, so it can be filled straight from v2v.
+static SparseMatrix
+pattern_matrix (const msh::csr_graph& v2v)
+{
+  const msh::index_t n = v2v.size ();
+  SparseMatrix a (n, n, v2v.idx.size () + n);
+  octave_idx_type *cidx = a.cidx (), *ridx = a.ridx ();
+  double *data = a.data ();
+#pragma omp parallel for
+  for (msh::index_t i = 0; i <= n; ++i)
+    cidx[i] = v2v.ptr[i] + i;
+#pragma omp parallel for
+  for (msh::index_t i = 0; i < n; ++i)
+    {
+      octave_idx_type pos = cidx[i];
+      bool diag = false;
+      for (msh::index_t q = v2v.ptr[i]; q < v2v.ptr[i+1]; ++q)
+        {
+          if (! diag && v2v.idx[q] > i)
+            {
+              ridx[pos++] = i;
+              diag = true;
+            }
+          ridx[pos++] = v2v.idx[q];
+        }
+      if (! diag)
+        ridx[pos++] = i;
+      std::fill (data + cidx[i], data + pos, 1.0);
+    }
+  return a;
+}
+
+template <typename T>
+static octave_value_list
+adjacency (const msh::mesh_view<T>& m, const octave_value_list& args)
+{
+  const int nprop = args.length ();
+  octave_value_list retval (nprop);
+  msh::csr_graph v2c, v2v, c2c;
+
+  for (int nn = 0; nn < nprop; ++nn)
+    {
+      std::string request = args(nn).string_value ();
+      const bool need_v2c = request == "v2c" || request == "v2v"
+                            || request == "pattern";
+      if (need_v2c && v2c.ptr.empty ())
+        msh::build_v2c (m, v2c);
+      if ((request == "v2v" || request == "pattern") && v2v.ptr.empty ())
+        msh::build_v2v (m, v2c, v2v);
+
+      if (request == "v2c")
+        retval(nn) = csr_struct (v2c);
+      else if (request == "v2v")
+        retval(nn) = csr_struct (v2v);
+      else if (request == "pattern")
+        retval(nn) = pattern_matrix (v2v);
+      else if (request == "c2c")
+        {
+          if (c2c.ptr.empty ())
+            msh::build_c2c (m, c2c);
+          retval(nn) = csr_struct (c2c);
+        }
+      else
+        {
+          warning ("mshm_adjacency: unexpected value in property string. "
+                   "Empty vector passed as output.");
+          retval(nn) = Matrix ();
+        }
+    }
+  return retval;
+}
+
+DEFUN_DLD (mshm_adjacency, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{varargout}]} = \
+mshm_adjacency (@var{mesh}, @var{string1}, @var{string2}, @dots{})\n\
+Compute the adjacency of the nodes and elements of a triangular or \
+tetrahedral mesh in compressed sparse row (CSR) form.\n\
+\n\
+Each CSR output is a structure with the fields @code{ptr} and \
+@code{idx}: the neighbours of item @var{i} are \
+@code{idx(ptr(i):ptr(i+1)-1)}.  Valid properties are:\n\
+@itemize @bullet\n\
+@item @code{\"v2c\"}: the elements containing each node, in \
+increasing order;\n\
+@item @code{\"v2v\"}: the nodes sharing an element with each node, in \
+increasing order and excluding the node itself;\n\
+@item @code{\"c2c\"}: the elements sharing a side (in 2D) or a face \
+(in 3D) with each element, listed in the order of the sides or faces \
+opposite to the first, second, @dots{} vertex of the element; sides \
+and faces on the boundary contribute no entry;\n\
+@item @code{\"pattern\"}: a sparse matrix with size the number of \
+nodes, with ones in the entries (i,j) such that nodes i and j are equal \
+or share an element, which is the sparsity pattern of the matrices \
+assembled on the mesh with linear elements.\n\
+@end itemize\n\
+\n\
+The adjacency arrays are built in parallel with counting sorts, and \
+the results do not depend on the number of threads.  @var{mesh} may \
+also be in the compact representation built by @code{mshm_compact}.\n\
+The output will contain the properties requested in the input in the \
+same order specified in the function call.\n\
+@seealso{msh2m_topological_properties, msh3m_topological_properties}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin < 2)
+    print_usage ();
+  for (int nn = 1; nn < nargin; ++nn)
+    if (! args(nn).is_string ())
+      error ("mshm_adjacency: only string value admitted for properties.");
+
+  msh::octave_mesh mesh (args(0), "mshm_adjacency");
+  octave_value_list props = args.slice (1, nargin - 1);
+  return mesh.compact () ? adjacency (mesh.cview (), props)
+                         : adjacency (mesh.view (), props);
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4, "left");
+%! [v2c, v2v, c2c, pattern] = mshm_adjacency (mesh, "v2c", "v2v", "c2c", "pattern");
+%! t = mesh.t(1:3,:);
+%! for i = 1:columns (mesh.p)
+%!   assert (v2c.idx(v2c.ptr(i):v2c.ptr(i+1)-1), find (any (t == i))')
+%!   nb = setdiff (unique (t(:,any (t == i))), i);
+%!   assert (v2v.idx(v2v.ptr(i):v2v.ptr(i+1)-1), nb)
+%! endfor
+%! n = msh2m_topological_properties (mesh, "n");
+%! assert (c2c.idx, n(! isnan (n)))
+%! sides = msh2m_topological_properties (mesh, "sides");
+%! assert (pattern, spones (sparse (sides(1,:), sides(2,:), 1, 9, 9) + sparse (sides(2,:), sides(1,:), 1, 9, 9) + speye (9)))
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! [v2v, pattern] = mshm_adjacency (mshm_compact (mesh), "v2v", "pattern");
+%! assert (diff (v2v.ptr), full (sum (pattern, 1))' - 1)
+%! t = mesh.t(1:4,:);
+%! [i, j] = find (pattern);
+%! assert (numel (i), columns (mesh.p) + numel (v2v.idx))
+%! for k = 1:numel (i)
+%!   assert (i(k) == j(k) || any (sum (t == i(k)) & sum (t == j(k))))
+%! endfor
+*/
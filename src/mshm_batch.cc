@@ -0,0 +1,432 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <octave/Cell.h>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+// Work items are chunks of at most this many elements, so that a batch
+// mixing small and large meshes still keeps all the threads busy.
+static const msh::index_t chunk_size = 16384;
+
+struct structured_job
+{
+  std::vector<double> x, y, z;
+  double region;
+  double sides[6];
+  bool left;
+  double *p, *e, *t;
+};
+
+static std::vector<double>
+sorted_vector (const octave_value& v, const char *name)
+{
+  if (! (v.isnumeric () && v.is_vector () && v.numel () > 1))
+    error ("mshm_batch: %s must be valid numeric vectors.", name);
+  NDArray a = v.array_value ();
+  std::vector<double> x (a.data (), a.data () + a.numel ());
+  std::sort (x.begin (), x.end ());
+  return x;
+}
+
+static Cell
+batch_structured_mesh (const Cell& jobs, int dim)
+{
+  const char *caller = dim == 2 ? "msh2m_structured_mesh"
+                                : "msh3m_structured_mesh";
+  octave_idx_type njobs = jobs.numel ();
+  std::vector<structured_job> job (njobs);
+  Cell retval (jobs.dims ());
+  std::vector<NDArray> p (njobs), e (njobs), t (njobs);
+
+  for (octave_idx_type ii = 0; ii < njobs; ++ii)
+    {
+      if (! jobs(ii).iscell ())
+        error ("mshm_batch: the arguments of each call to %s must be "
+               "given as a cell array", caller);
+      Cell a = jobs(ii).cell_value ();
+      structured_job& jb = job[ii];
+      msh::structured_size sz;
+
+      if (dim == 2)
+        {
+          if (a.numel () < 4 || a.numel () > 5)
+            error ("mshm_batch: wrong number of input parameters for %s.",
+                   caller);
+          jb.x = sorted_vector (a(0), "X and Y");
+          jb.y = sorted_vector (a(1), "X and Y");
+          jb.left = false;
+          if (a.numel () == 5)
+            {
+              std::string orient = a(4).string_value ();
+              if (orient == "left")
+                jb.left = true;
+              else if (orient != "right")
+                error ("mshm_batch: only the \"right\" and \"left\" "
+                       "orientations are supported.");
+            }
+          sz = msh::structured_mesh_size (jb.x.size (), jb.y.size ());
+        }
+      else
+        {
+          if (a.numel () != 5)
+            error ("mshm_batch: wrong number of input parameters for %s.",
+                   caller);
+          jb.x = sorted_vector (a(0), "X, Y, Z");
+          jb.y = sorted_vector (a(1), "X, Y, Z");
+          jb.z = sorted_vector (a(2), "X, Y, Z");
+          sz = msh::structured_mesh_size (jb.x.size (), jb.y.size (),
+                                          jb.z.size ());
+        }
+
+      const int nsides = 2 * dim;
+      octave_value region = a(dim), sides = a(dim + 1);
+      if (! (region.isnumeric () && region.numel () == 1))
+        error ("mshm_batch: REGION must be a valid scalar.");
+      if (! (sides.isnumeric () && sides.numel () == nsides))
+        error ("mshm_batch: SIDES must be a %d components vector.", nsides);
+      jb.region = region.double_value ();
+      NDArray s = sides.array_value ();
+      std::copy (s.data (), s.data () + nsides, jb.sides);
+
+      p[ii] = NDArray (dim_vector (dim, sz.np));
+      e[ii] = NDArray (dim_vector (dim == 2 ? 7 : 10, sz.ne));
+      t[ii] = NDArray (dim_vector (dim + 2, sz.nt));
+      jb.p = p[ii].fortran_vec ();
+      jb.e = e[ii].fortran_vec ();
+      jb.t = t[ii].fortran_vec ();
+    }
+
+#pragma omp parallel for schedule (dynamic, 1)
+  for (octave_idx_type ii = 0; ii < njobs; ++ii)
+    {
+      const structured_job& jb = job[ii];
+      if (dim == 2)
+        msh::structured_mesh_2d (jb.x.data (), jb.x.size (),
+                                 jb.y.data (), jb.y.size (),
+                                 jb.region, jb.sides, jb.left,
+                                 jb.p, jb.e, jb.t);
+      else
+        msh::structured_mesh_3d (jb.x.data (), jb.x.size (),
+                                 jb.y.data (), jb.y.size (),
+                                 jb.z.data (), jb.z.size (),
+                                 jb.region, jb.sides, jb.p, jb.e, jb.t);
+    }
+
+  for (octave_idx_type ii = 0; ii < njobs; ++ii)
+    retval(ii) = msh::make_mesh (p[ii], e[ii], t[ii]);
+
+  return retval;
+}
+
+enum property_id { prop_bar, prop_area, prop_wjacdet, prop_shg,
+                   prop_midedge, prop_none };
+
+struct property_task
+{
+  const msh::octave_mesh *mesh;
+  property_id prop;
+  msh::index_t j0, j1;
+  double *out;
+};
+
+template <typename T>
+static void
+compute_property (const msh::mesh_view<T>& m, const property_task& tk)
+{
+  switch (tk.prop)
+    {
+    case prop_bar:
+      msh::element_bar (m, tk.j0, tk.j1, tk.out);
+      break;
+    case prop_area:
+      msh::element_area (m, tk.j0, tk.j1, tk.out);
+      break;
+    case prop_wjacdet:
+      msh::element_wjacdet (m, tk.j0, tk.j1, tk.out);
+      break;
+    case prop_shg:
+      msh::element_shg (m, tk.j0, tk.j1, tk.out);
+      break;
+    case prop_midedge:
+      msh::element_midedge (m, tk.j0, tk.j1, tk.out);
+      break;
+    default:
+      break;
+    }
+}
+
+static octave_value_list
+batch_geometrical_properties (const Cell& meshes,
+                              const octave_value_list& args)
+{
+  octave_idx_type nmesh = meshes.numel ();
+  int nprop = args.length ();
+  std::vector<msh::octave_mesh> mesh (nmesh);
+  std::vector<Cell> out (nprop, Cell (meshes.dims ()));
+  std::vector<property_task> tasks;
+
+  for (int nn = 0; nn < nprop; ++nn)
+    if (! args(nn).is_string ())
+      error ("mshm_batch: only string value admitted for properties.");
+
+  for (octave_idx_type ii = 0; ii < nmesh; ++ii)
+    {
+      mesh[ii].init (meshes(ii), "mshm_batch");
+      const msh::index_t nt = mesh[ii].nt ();
+      octave_scalar_map s = meshes(ii).scalar_map_value ();
+      const int dim = mesh[ii].dim ();
+
+      for (int nn = 0; nn < nprop; ++nn)
+        {
+          std::string request = args(nn).string_value ();
+
+          // Reuse the properties already stored in the mesh, as the
+          // m-files do.
+          if (s.isfield (request))
+            {
+              out[nn](ii) = s.contents (request);
+              continue;
+            }
+
+          property_id prop = prop_none;
+          dim_vector dv;
+          if (request == "bar")
+            {
+              prop = prop_bar;
+              dv = dim_vector (dim, nt);
+            }
+          else if (request == "area")
+            {
+              prop = prop_area;
+              dv = dim == 2 ? dim_vector (nt, 1) : dim_vector (1, nt);
+            }
+          else if (request == "wjacdet")
+            {
+              prop = prop_wjacdet;
+              dv = dim_vector (dim + 1, nt);
+            }
+          else if (request == "shg")
+            {
+              prop = prop_shg;
+              dv = dim_vector (dim, dim + 1, nt);
+            }
+          else if (request == "midedge" && dim == 2)
+            {
+              prop = prop_midedge;
+              dv = dim_vector (2, 3, nt);
+            }
+          else if (request == "shp" && dim == 3)
+            {
+              out[nn](ii) = DiagMatrix (4, 4, 1.0);
+              continue;
+            }
+          else
+            {
+              warning ("mshm_batch: unexpected value in property string. "
+                       "Empty vector passed as output.");
+              out[nn](ii) = Matrix ();
+              continue;
+            }
+
+          NDArray b (dv);
+          double *bvec = b.fortran_vec ();
+          for (msh::index_t j0 = 0; j0 < nt; j0 += chunk_size)
+            {
+              property_task tk = {&mesh[ii], prop, j0,
+                                  std::min (j0 + chunk_size, nt), bvec};
+              tasks.push_back (tk);
+            }
+          out[nn](ii) = b;
+        }
+    }
+
+  octave_idx_type ntasks = tasks.size ();
+#pragma omp parallel for schedule (dynamic, 1)
+  for (octave_idx_type kk = 0; kk < ntasks; ++kk)
+    {
+      const property_task& tk = tasks[kk];
+      if (tk.mesh->compact ())
+        compute_property (tk.mesh->cview (), tk);
+      else
+        compute_property (tk.mesh->view (), tk);
+    }
+
+  octave_value_list retval (nprop);
+  for (int nn = 0; nn < nprop; ++nn)
+    retval(nn) = out[nn];
+  return retval;
+}
+
+static void
+batch_gmsh_write (const Cell& meshes, const Cell& names)
+{
+  octave_idx_type nmesh = meshes.numel ();
+  if (! (names.iscellstr () && names.numel () == nmesh))
+    error ("mshm_batch: FILENAMES must be a cell array of strings with "
+           "one entry for each mesh");
+
+  std::vector<msh::octave_mesh> mesh (nmesh);
+  std::vector<std::string> fname (nmesh);
+  for (octave_idx_type ii = 0; ii < nmesh; ++ii)
+    {
+      mesh[ii].init (meshes(ii), "mshm_batch");
+      fname[ii] = names(ii).string_value ();
+      const int dim = mesh[ii].dim ();
+      if (mesh[ii].ne () > 0
+          && mesh[ii].label_rows () < msh::standard_erows (dim))
+        error ("mshm_batch: the mesh field e must have %d rows",
+               dim == 2 ? 7 : 10);
+    }
+
+  std::vector<char> failed (nmesh, 0);
+#pragma omp parallel for schedule (dynamic, 1)
+  for (octave_idx_type ii = 0; ii < nmesh; ++ii)
+    {
+      std::FILE *fp = std::fopen (fname[ii].c_str (), "w");
+      if (! fp)
+        failed[ii] = 1;
+      else
+        {
+          const bool ok = mesh[ii].compact ()
+                          ? msh::gmsh_write (mesh[ii].cview (), fp)
+                          : msh::gmsh_write (mesh[ii].view (), fp);
+          if (! ok)
+            failed[ii] = 1;
+          if (std::fclose (fp))
+            failed[ii] = 1;
+        }
+    }
+
+  for (octave_idx_type ii = 0; ii < nmesh; ++ii)
+    if (failed[ii])
+      error ("mshm_batch: unable to write file %s", fname[ii].c_str ());
+}
+
+DEFUN_DLD (mshm_batch, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{meshes}]} = \
+mshm_batch (\"msh2m_structured_mesh\", @var{arglist})\n\
+@deftypefnx {Function File} {[@var{meshes}]} = \
+mshm_batch (\"msh3m_structured_mesh\", @var{arglist})\n\
+@deftypefnx {Function File} {[@var{prop1}, @var{prop2}, @dots{}]} = \
+mshm_batch (\"geometrical_properties\", @var{meshes}, @var{string1}, \
+@var{string2}, @dots{})\n\
+@deftypefnx {Function File} {} = \
+mshm_batch (\"gmsh_write\", @var{meshes}, @var{filenames})\n\
+Process a whole set of meshes in a single call.\n\
+\n\
+The work is split among all the available threads (see \
+@code{OMP_NUM_THREADS}) and the results are returned as cell arrays \
+with the same size as the input cell arrays.\n\
+\n\
+@itemize @bullet\n\
+@item @code{\"msh2m_structured_mesh\"}, @code{\"msh3m_structured_mesh\"}: \
+each entry of the cell array @var{arglist} is itself a cell array with \
+the arguments of a call to @code{msh2m_structured_mesh} or \
+@code{msh3m_structured_mesh}.  The meshes returned in @var{meshes} are \
+identical to the ones built by those functions.  The @code{\"random\"} \
+orientation is not supported.\n\
+@item @code{\"geometrical_properties\"}: compute the properties \
+identified by the input strings for every mesh in the cell array \
+@var{meshes}.  The properties @code{\"bar\"}, @code{\"area\"}, \
+@code{\"wjacdet\"} and @code{\"shg\"} are available for 2D and 3D meshes, \
+@code{\"midedge\"} for 2D meshes and @code{\"shp\"} for 3D meshes; they \
+have the same meaning as in @code{msh2m_geometrical_properties} and \
+@code{msh3m_geometrical_properties}.\n\
+@item @code{\"gmsh_write\"}: write each mesh in @var{meshes} to the \
+file with the corresponding name in the cell array @var{filenames}, \
+using the same format as @code{msh2m_gmsh_write} and \
+@code{msh3m_gmsh_write}.\n\
+@end itemize\n\
+The meshes passed to @code{\"geometrical_properties\"} and \
+@code{\"gmsh_write\"} may also be in the compact representation built \
+by @code{mshm_compact}.\n\
+@seealso{msh2m_structured_mesh, msh3m_structured_mesh, \
+msh2m_geometrical_properties, msh3m_geometrical_properties, \
+msh2m_gmsh_write, msh3m_gmsh_write}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin < 2 || ! args(0).is_string ())
+    print_usage ();
+
+  std::string op = args(0).string_value ();
+  if (! args(1).iscell ())
+    error ("mshm_batch: the second argument must be a cell array");
+  Cell items = args(1).cell_value ();
+
+  if (op == "msh2m_structured_mesh" || op == "msh3m_structured_mesh")
+    {
+      if (nargin != 2)
+        print_usage ();
+      retval(0) = batch_structured_mesh (items, op[3] == '2' ? 2 : 3);
+    }
+  else if (op == "geometrical_properties")
+    {
+      if (nargin < 3)
+        error ("mshm_batch: wrong number of input parameters.");
+      retval = batch_geometrical_properties (items, args.slice (2, nargin - 2));
+    }
+  else if (op == "gmsh_write")
+    {
+      if (nargin != 3 || ! args(2).iscell ())
+        print_usage ();
+      batch_gmsh_write (items, args(2).cell_value ());
+    }
+  else
+    error ("mshm_batch: unknown operation %s", op.c_str ());
+
+  return retval;
+}
+
+/*
+%!test
+%! args = {{0:.5:1, 0:.5:1, 1, 1:4, "left"}, {linspace(0,1,7), 0:.25:2, 2, 5:8}};
+%! meshes = mshm_batch ("msh2m_structured_mesh", args);
+%! assert (size (meshes), [1 2])
+%! assert (meshes{1}, msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4, "left"))
+%! assert (meshes{2}, msh2m_structured_mesh (linspace(0,1,7), 0:.25:2, 2, 5:8))
+
+%!test
+%! x = y = z = linspace (0, 1, 4);
+%! meshes = mshm_batch ("msh3m_structured_mesh", {{x, y, z, 1, 1:6}; {x, 0:.5:1, z, 3, 2:7}});
+%! assert (meshes{1}, msh3m_structured_mesh (x, y, z, 1, 1:6))
+%! assert (meshes{2}, msh3m_structured_mesh (x, 0:.5:1, z, 3, 2:7))
+
+%!test
+%! m2 = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4, "left");
+%! m3 = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! [bar, area, shg] = mshm_batch ("geometrical_properties", {m2, m3}, "bar", "area", "shg");
+%! [b2, a2, s2] = msh2m_geometrical_properties (m2, "bar", "area", "shg");
+%! [b3, a3, s3] = msh3m_geometrical_properties (m3, "bar", "area", "shg");
+%! assert (bar{1}, b2, 1e-12)
+%! assert (area{1}, a2, 1e-12)
+%! assert (shg{1}, s2, 1e-12)
+%! assert (bar{2}, b3, 1e-12)
+%! assert (area{2}, a3, 1e-12)
+%! assert (shg{2}, s3, 1e-12)
+*/
@@ -0,0 +1,99 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+DEFUN_DLD (mshm_boundary_index, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{bindex}]} = \
+mshm_boundary_index (@var{mesh})\n\
+Build an index of the sides (in 2D) or faces (in 3D) of @var{mesh}.e \
+and of their nodes grouped by boundary label, that is by the entries \
+of the fifth row of @var{mesh}.e in 2D and of the tenth row in 3D.\n\
+\n\
+@var{bindex} is a structure with the following fields:\n\
+@table @code\n\
+@item labels\n\
+the labels used in @var{mesh}.e, in increasing order;\n\
+@item fptr, fidx\n\
+the columns of @var{mesh}.e with label @code{labels(i)} are \
+@code{fidx(fptr(i):fptr(i+1)-1)};\n\
+@item nptr, nidx\n\
+the nodes on these sides or faces are \
+@code{nidx(nptr(i):nptr(i+1)-1)}.\n\
+@end table\n\
+All the lists are sorted and contain no repetitions.\n\
+\n\
+Store @var{bindex} in the field @code{bindex} of @var{mesh} to have \
+@code{msh2m_nodes_on_sides}, @code{msh3m_nodes_on_faces} and \
+@code{mshm_boundary_nodes} use it instead of searching @var{mesh}.e \
+again at each call.  As for the other properties stored in the mesh \
+structure, the index must be rebuilt whenever @var{mesh}.e changes.\n\
+@seealso{mshm_boundary_nodes, msh2m_nodes_on_sides, \
+msh3m_nodes_on_faces}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  if (args.length () != 1)
+    print_usage ();
+
+  msh::octave_mesh mesh (args(0), "mshm_boundary_index");
+  msh::label_index li;
+  if (mesh.compact ())
+    msh::build_label_index (mesh.cview (), li);
+  else
+    msh::build_label_index (mesh.view (), li);
+
+  RowVector labels (li.num_labels ());
+  std::copy (li.labels.begin (), li.labels.end (), labels.fortran_vec ());
+
+  octave_scalar_map bindex;
+  bindex.setfield ("labels", labels);
+  bindex.setfield ("fptr", msh::one_based (li.fptr));
+  bindex.setfield ("fidx", msh::one_based (li.fidx));
+  bindex.setfield ("nptr", msh::one_based (li.nptr));
+  bindex.setfield ("nidx", msh::one_based (li.nidx));
+  retval(0) = bindex;
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, [3 1 3 7], "left");
+%! bindex = mshm_boundary_index (mesh);
+%! assert (bindex.labels, [1 3 7])
+%! assert (bindex.fptr, [1 3 7 9]')
+%! for l = 1:3
+%!   ff = find (mesh.e(5,:) == bindex.labels(l))';
+%!   assert (bindex.fidx(bindex.fptr(l):bindex.fptr(l+1)-1), ff)
+%!   assert (bindex.nidx(bindex.nptr(l):bindex.nptr(l+1)-1), unique (mesh.e(1:2,ff)(:)))
+%! endfor
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! bindex = mshm_boundary_index (mshm_compact (mesh));
+%! assert (bindex, mshm_boundary_index (mesh))
+%! assert (bindex.labels, 1:6)
+%! assert (diff (bindex.nptr), 9 * ones (6, 1))
+*/
@@ -0,0 +1,172 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+// Check the layout of an index built by mshm_boundary_index, so that
+// the merge can trust its offsets.
+static void
+check_bindex (const octave_scalar_map& b, NDArray& labels,
+              NDArray& ptr, NDArray& idx, const std::string& list)
+{
+  static const char *fields[] = {"labels", "fptr", "fidx", "nptr", "nidx"};
+  for (int k = 0; k < 5; ++k)
+    if (! b.isfield (fields[k]))
+      error ("mshm_boundary_nodes: BINDEX has no field %s", fields[k]);
+
+  labels = b.getfield ("labels").array_value ();
+  ptr = b.getfield (list + "ptr").array_value ();
+  idx = b.getfield (list + "idx").array_value ();
+  const msh::index_t nl = labels.numel ();
+  bool valid = ptr.numel () == nl + 1 && ptr(0) == 1
+               && ptr(nl) == idx.numel () + 1;
+  for (msh::index_t l = 0; valid && l < nl; ++l)
+    valid = ptr(l) <= ptr(l+1) && (l == 0 || labels(l-1) < labels(l));
+  if (! valid)
+    error ("mshm_boundary_nodes: BINDEX is not a valid boundary index");
+}
+
+// Positions in the sorted labels of the requested ones, -1 for labels
+// not used in the mesh.
+static std::vector<msh::index_t>
+label_positions (const double *labels, msh::index_t nl,
+                 const NDArray& request)
+{
+  std::vector<msh::index_t> sel (request.numel ());
+  for (msh::index_t s = 0; s < request.numel (); ++s)
+    {
+      const double *it = std::lower_bound (labels, labels + nl, request(s));
+      sel[s] = it != labels + nl && *it == request(s) ? it - labels : -1;
+    }
+  return sel;
+}
+
+DEFUN_DLD (mshm_boundary_nodes, args, nargout, "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{nodelist}, @var{facetlist}]} = \
+mshm_boundary_nodes (@var{bindex}, @var{labellist})\n\
+@deftypefnx {Function File} {[@var{nodelist}, @var{facetlist}]} = \
+mshm_boundary_nodes (@var{mesh}, @var{labellist})\n\
+Return the nodes lying on the sides (in 2D) or faces (in 3D) of a mesh \
+whose boundary label is in @var{labellist}, as a sorted column vector \
+without repetitions.  The optional output @var{facetlist} contains the \
+corresponding columns of the e field of the mesh, sorted.\n\
+\n\
+The first argument is an index built by @code{mshm_boundary_index}, or \
+a mesh.  If @var{mesh} has a field @code{bindex} this is used as the \
+index, otherwise a temporary index is built.  With an index the \
+result is obtained by merging the sorted lists stored for each label, \
+without searching the sides or faces of the mesh again.  Labels not \
+used in the mesh are ignored.\n\
+@seealso{mshm_boundary_index, msh2m_nodes_on_sides, \
+msh3m_nodes_on_faces}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  if (args.length () != 2)
+    print_usage ();
+  if (! args(1).isnumeric ())
+    error ("mshm_boundary_nodes: only numeric value admitted as labellist.");
+  const NDArray request = args(1).array_value ();
+
+  octave_scalar_map b;
+  if (args(0).isstruct ())
+    b = args(0).scalar_map_value ();
+  else
+    error ("mshm_boundary_nodes: first input is not a mesh or an index");
+
+  const bool ismesh = b.isfield ("p") && b.isfield ("e") && b.isfield ("t");
+  if (ismesh && ! b.isfield ("bindex"))
+    {
+      msh::octave_mesh mesh (args(0), "mshm_boundary_nodes");
+      msh::label_index li;
+      if (mesh.compact ())
+        msh::build_label_index (mesh.cview (), li);
+      else
+        msh::build_label_index (mesh.view (), li);
+
+      std::vector<msh::index_t> sel
+        = label_positions (li.labels.data (), li.num_labels (), request);
+      std::vector<msh::index_t> nodes, facets;
+      msh::merge_sorted_lists (li.nptr.data (), li.nidx.data (), 0,
+                               sel.data (), sel.size (), nodes);
+      retval(0) = msh::one_based (nodes);
+      if (nargout > 1)
+        {
+          msh::merge_sorted_lists (li.fptr.data (), li.fidx.data (), 0,
+                                   sel.data (), sel.size (), facets);
+          retval(1) = msh::one_based (facets);
+        }
+      return retval;
+    }
+
+  if (ismesh)
+    b = b.getfield ("bindex").scalar_map_value ();
+
+  for (int k = 0; k < std::max (nargout, 1) && k < 2; ++k)
+    {
+      NDArray labels, ptr, idx;
+      check_bindex (b, labels, ptr, idx, k == 0 ? "n" : "f");
+      std::vector<msh::index_t> sel
+        = label_positions (labels.data (), labels.numel (), request);
+      std::vector<double> out;
+      msh::merge_sorted_lists (ptr.data (), idx.data (), 1,
+                               sel.data (), sel.size (), out);
+      ColumnVector list (out.size ());
+      std::copy (out.begin (), out.end (), list.fortran_vec ());
+      retval(k) = list;
+    }
+
+  return retval;
+}
+
+/*
+%!shared mesh
+%! mesh1 = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4, "left");
+%! mesh2 = msh2m_structured_mesh (1:.5:2, 0:.5:1, 1, 1:4, "left");
+%! mesh = msh2m_join_structured_mesh (mesh1, mesh2, 2, 4);
+
+%!test
+%! [nodes, facets] = mshm_boundary_nodes (mesh, [1 2]);
+%! assert (nodes, [1 4 7 8 9]')
+%! assert (facets, sort ([find(mesh.e(5,:) == 1), find(mesh.e(5,:) == 2)])')
+
+%!test
+%! bindex = mshm_boundary_index (mesh);
+%! for labels = {1, [2 1], [7 5 3 1], [1 100], 100, []}
+%!   [nodes, facets] = mshm_boundary_nodes (bindex, labels{1});
+%!   ff = find (ismember (mesh.e(5,:), labels{1}));
+%!   assert (nodes, unique (mesh.e(1:2,ff)(:)))
+%!   assert (facets, ff(:))
+%! endfor
+%! mesh.bindex = bindex;
+%! assert (mshm_boundary_nodes (mesh, [3 4]), mshm_boundary_nodes (bindex, [3 4]))
+
+%!error <not a valid boundary index>
+%! bindex = mshm_boundary_index (mesh);
+%! bindex.nptr(end) += 1;
+%! mshm_boundary_nodes (bindex, 1);
+*/
@@ -0,0 +1,477 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+// Flags of the elements found by check_elements.
+enum element_flag
+{
+  element_inverted = 1,
+  element_degenerate = 2
+};
+
+// Flag the elements with negative orientation and those whose measure
+// is negligible with respect to their longest edge, or which have
+// repeated vertices.  In 2D either orientation is valid, so that the
+// inverted elements are those listed in the opposite sense to most of
+// the elements connected to them through their sides, and the
+// clockwise ones in case of a tie.
+template <typename T>
+static void
+check_elements (const msh::mesh_view<T>& m, std::vector<unsigned char>& flag)
+{
+  const int nv = m.dim + 1, nle = msh::num_local_edges (m.dim);
+  const double eps = 1e3 * std::numeric_limits<double>::epsilon ();
+  flag.assign (m.nt, 0);
+#pragma omp parallel for
+  for (msh::index_t j = 0; j < m.nt; ++j)
+    {
+      bool repeated = false;
+      for (int a = 0; a < nv; ++a)
+        for (int b = a + 1; b < nv; ++b)
+          repeated = repeated || m.tv (a, j) == m.tv (b, j);
+      double h2 = 0;
+      for (int k = 0; k < nle; ++k)
+        {
+          const int *le = msh::local_edge (m.dim, k);
+          const double *x = m.point (m.tv (le[0], j));
+          const double *y = m.point (m.tv (le[1], j));
+          double d2 = 0;
+          for (int d = 0; d < m.dim; ++d)
+            d2 += (x[d] - y[d]) * (x[d] - y[d]);
+          h2 = std::max (h2, d2);
+        }
+      const double det = msh::element_jacdet (m, j);
+      const double scale = m.dim == 2 ? h2 : h2 * std::sqrt (h2);
+      if (repeated || std::abs (det) <= eps * scale)
+        flag[j] = element_degenerate;
+      else if (det < 0)
+        flag[j] = element_inverted;
+    }
+  if (m.dim != 2)
+    return;
+
+  msh::facet_table ft;
+  msh::build_facet_table (m, ft);
+  msh::disjoint_sets part (m.nt);
+  for (msh::index_t f = 0; f < ft.num_facets (); ++f)
+    {
+      const msh::index_t j0 = ft.cell[2 * f], j1 = ft.cell[2 * f + 1];
+      if (j1 >= 0 && flag[j0] != element_degenerate
+          && flag[j1] != element_degenerate)
+        part.join (j0, j1);
+    }
+  std::vector<msh::index_t> balance (m.nt, 0);
+  for (msh::index_t j = 0; j < m.nt; ++j)
+    if (flag[j] != element_degenerate)
+      balance[part.find (j)] += flag[j] == element_inverted ? -1 : 1;
+  for (msh::index_t j = 0; j < m.nt; ++j)
+    if (flag[j] != element_degenerate && balance[part.find (j)] < 0)
+      flag[j] ^= element_inverted;
+}
+
+// Nodes which are not vertices of any element.
+template <typename T>
+static void
+unused_nodes (const msh::mesh_view<T>& m, std::vector<unsigned char>& used)
+{
+  used.assign (m.np, 0);
+#pragma omp parallel for
+  for (msh::index_t j = 0; j < m.nt; ++j)
+    for (int k = 0; k <= m.dim; ++k)
+      {
+#pragma omp atomic write
+        used[m.tv (k, j)] = 1;
+      }
+}
+
+template <typename T>
+static double
+bounding_box_diameter (const msh::mesh_view<T>& m)
+{
+  double d2 = 0;
+  for (int d = 0; d < m.dim; ++d)
+    {
+      double lo = HUGE_VAL, hi = -HUGE_VAL;
+      for (msh::index_t i = 0; i < m.np; ++i)
+        {
+          lo = std::min (lo, m.point (i)[d]);
+          hi = std::max (hi, m.point (i)[d]);
+        }
+      if (m.np > 0)
+        d2 += (hi - lo) * (hi - lo);
+    }
+  return std::sqrt (d2);
+}
+
+// Indices of the entries of flag with the given bits set, in
+// increasing order.
+static std::vector<msh::index_t>
+flagged (const std::vector<unsigned char>& flag, unsigned char bits)
+{
+  std::vector<msh::index_t> idx;
+  for (std::size_t i = 0; i < flag.size (); ++i)
+    if (flag[i] & bits)
+      idx.push_back (i);
+  return idx;
+}
+
+// Result of the checks on a mesh.
+struct check_result
+{
+  std::vector<unsigned char> element;   // element_flag bits
+  std::vector<unsigned char> used;      // 1 for nodes of some element
+  std::vector<msh::index_t> rep;        // representative of each node
+  std::vector<msh::index_t> nonmanifold;// dim x k facet vertices
+};
+
+template <typename T>
+static void
+check_mesh (const msh::mesh_view<T>& m, double tol, check_result& r)
+{
+  check_elements (m, r.element);
+  unused_nodes (m, r.used);
+
+  const double diam = bounding_box_diameter (m);
+  const double h = std::max (tol, diam > 0 ? 1e-12 * diam : 1.0);
+  msh::find_duplicate_nodes (m.p, m.dim, m.np, tol, h, r.rep);
+
+  msh::facet_table ft;
+  msh::build_facet_table (m, ft);
+  r.nonmanifold.clear ();
+  for (msh::index_t f = 0; f < ft.num_facets (); ++f)
+    if (ft.count[f] > 2)
+      r.nonmanifold.insert (r.nonmanifold.end (), &ft.verts[m.dim * f],
+                            &ft.verts[m.dim * (f + 1)]);
+}
+
+// Build the repaired mesh: duplicate nodes are merged, the elements
+// left with repeated vertices are removed, the inverted ones are
+// reoriented and the unused nodes are dropped, together with the sides
+// or faces in e which are no longer on the mesh.
+static void
+repair_mesh (int dim, const NDArray& p, const NDArray& e, const NDArray& t,
+             const std::vector<msh::index_t>& rep, NDArray& p2, NDArray& e2,
+             NDArray& t2)
+{
+  const msh::index_t np = p.cols (), nt = t.cols (), ne = e.cols ();
+  const msh::index_t trows = t.rows (), erows = e.rows ();
+  const double *tvec = t.data (), *evec = e.data ();
+
+  NDArray tm (dim_vector (trows, nt));
+  double *tmvec = tm.fortran_vec ();
+#pragma omp parallel for
+  for (msh::index_t j = 0; j < nt; ++j)
+    for (msh::index_t r = 0; r < trows; ++r)
+      tmvec[r + trows * j] = r <= dim
+        ? rep[static_cast<msh::index_t> (tvec[r + trows * j]) - 1] + 1
+        : tvec[r + trows * j];
+
+  msh::mesh_view<double> m;
+  m.dim = dim;
+  m.np = np;
+  m.ne = 0;
+  m.nt = nt;
+  m.p = p.data ();
+  m.e = 0;
+  m.t = tmvec;
+  m.erows = 0;
+  m.trows = trows;
+  m.set_inline_tags ();
+
+  std::vector<unsigned char> flag, used;
+  check_elements (m, flag);
+  std::vector<msh::index_t> keep;
+  for (msh::index_t j = 0; j < nt; ++j)
+    {
+      bool repeated = false;
+      for (int a = 0; a <= dim; ++a)
+        for (int b = a + 1; b <= dim; ++b)
+          repeated = repeated || m.tv (a, j) == m.tv (b, j);
+      if (! repeated)
+        keep.push_back (j);
+    }
+  m.nt = keep.size ();
+
+  t2 = NDArray (dim_vector (trows, keep.size ()));
+  double *t2vec = t2.fortran_vec ();
+#pragma omp parallel for
+  for (msh::index_t c = 0; c < m.nt; ++c)
+    {
+      const double *src = tmvec + trows * keep[c];
+      double *dst = t2vec + trows * c;
+      std::copy (src, src + trows, dst);
+      if (flag[keep[c]] & element_inverted)
+        std::swap (dst[0], dst[1]);
+    }
+  m.t = t2vec;
+
+  // Renumber the nodes still in use, keeping their order.
+  unused_nodes (m, used);
+  std::vector<msh::index_t> node (np, -1);
+  msh::index_t np2 = 0;
+  for (msh::index_t i = 0; i < np; ++i)
+    if (used[i])
+      node[i] = np2++;
+
+  p2 = NDArray (dim_vector (dim, np2));
+  double *p2vec = p2.fortran_vec ();
+  const double *pvec = p.data ();
+#pragma omp parallel for
+  for (msh::index_t i = 0; i < np; ++i)
+    if (node[i] >= 0)
+      std::copy (pvec + dim * i, pvec + dim * (i + 1), p2vec + dim * node[i]);
+#pragma omp parallel for
+  for (msh::index_t c = 0; c < m.nt; ++c)
+    for (int k = 0; k <= dim; ++k)
+      t2vec[k + trows * c] = node[m.tv (k, c)] + 1;
+
+  std::vector<msh::index_t> ekeep;
+  for (msh::index_t q = 0; q < ne; ++q)
+    {
+      msh::index_t v[3];
+      bool ok = true;
+      for (int a = 0; a < dim; ++a)
+        {
+          v[a] = node[rep[static_cast<msh::index_t> (evec[a + erows * q])
+                          - 1]];
+          ok = ok && v[a] >= 0;
+          for (int b = 0; b < a; ++b)
+            ok = ok && v[a] != v[b];
+        }
+      if (ok)
+        ekeep.push_back (q);
+    }
+  e2 = NDArray (dim_vector (erows, ekeep.size ()));
+  double *e2vec = e2.fortran_vec ();
+#pragma omp parallel for
+  for (msh::index_t c = 0; c < static_cast<msh::index_t> (ekeep.size ());
+       ++c)
+    {
+      const double *src = evec + erows * ekeep[c];
+      double *dst = e2vec + erows * c;
+      std::copy (src, src + erows, dst);
+      for (int a = 0; a < dim; ++a)
+        dst[a] = node[rep[static_cast<msh::index_t> (src[a]) - 1]] + 1;
+    }
+}
+
+DEFUN_DLD (mshm_check, args, nargout, "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{info}, @var{mesh2}]} = \
+mshm_check (@var{mesh})\n\
+@deftypefnx {Function File} {[@var{info}, @var{mesh2}]} = \
+mshm_check (@var{mesh}, \"tol\", @var{tol})\n\
+Check a triangular or tetrahedral mesh for common defects and, if a \
+second output is requested, repair them.\n\
+\n\
+@var{info} is a structure with the following fields, each one empty if \
+the corresponding defect is not found:\n\
+@table @asis\n\
+@item \"inverted\"\n\
+column vector of the elements with negative orientation, that is with \
+negative wjacdet in 3D; in 2D, where the triangles may be listed either \
+way, those listed in the opposite sense to most of the triangles \
+connected to them through their sides, or clockwise in case of a tie;\n\
+@item \"degenerate\"\n\
+column vector of the elements with repeated vertices or with a \
+negligible area (volume in 3D) with respect to their longest edge;\n\
+@item \"duplicate\"\n\
+2 x k matrix whose columns contain a node and the lowest numbered node \
+within a distance @var{tol} of it, directly or through other nodes;\n\
+@item \"unused\"\n\
+column vector of the nodes which are not vertices of any element;\n\
+@item \"nonmanifold\"\n\
+matrix whose columns contain the nodes of the sides (faces in 3D) \
+shared by more than two elements;\n\
+@item \"valid\"\n\
+true if all of the above are empty.\n\
+@end table\n\
+\n\
+@var{tol} defaults to 1e-10 times the diameter of the bounding box of \
+the mesh; with @var{tol} = 0 only nodes with the same coordinates are \
+duplicates.  Duplicate nodes are found by sorting the nodes on a grid \
+of spacing @var{tol}, and the elements are checked in parallel, so \
+that the check is cheap with respect to building the mesh.\n\
+\n\
+In @var{mesh2} the duplicate nodes are merged, the elements left with \
+repeated vertices are removed, the inverted elements are reoriented \
+and the unused nodes are removed, the remaining nodes keeping their \
+order; the columns of e are renumbered accordingly, and removed if \
+their nodes are removed or merged.  Degenerate elements with distinct \
+vertices and non-manifold sides or faces are reported but not \
+repaired.  @var{mesh2} contains only the fields p, e and t.  If \
+@var{mesh} is in the compact representation built by \
+@code{mshm_compact}, so is @var{mesh2}.\n\
+@seealso{msh2m_geometrical_properties, msh3m_geometrical_properties, \
+mshm_compact}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin != 1 && nargin != 3)
+    print_usage ();
+
+  msh::octave_mesh mesh (args(0), "mshm_check");
+  const int dim = mesh.dim ();
+  if ((mesh.compact () ? mesh.cview ().trows : mesh.view ().trows)
+      != dim + (mesh.compact () ? 1 : 2))
+    error ("mshm_check: the input mesh must be linear");
+
+  double tol = -1;
+  if (nargin == 3)
+    {
+      if (! (args(1).is_string () && args(1).string_value () == "tol"))
+        error ("mshm_check: the only property is \"tol\"");
+      if (! (args(2).isnumeric () && args(2).numel () == 1
+             && args(2).double_value () >= 0))
+        error ("mshm_check: TOL must be a non-negative scalar");
+      tol = args(2).double_value ();
+    }
+  if (tol < 0)
+    tol = 1e-10 * (mesh.compact () ? bounding_box_diameter (mesh.cview ())
+                                   : bounding_box_diameter (mesh.view ()));
+
+  check_result r;
+  if (mesh.compact ())
+    check_mesh (mesh.cview (), tol, r);
+  else
+    check_mesh (mesh.view (), tol, r);
+
+  std::vector<msh::index_t> dup;
+  for (std::size_t i = 0; i < r.rep.size (); ++i)
+    if (r.rep[i] != static_cast<msh::index_t> (i))
+      {
+        dup.push_back (i);
+        dup.push_back (r.rep[i]);
+      }
+  std::vector<unsigned char> unused (r.used.size ());
+  for (std::size_t i = 0; i < unused.size (); ++i)
+    unused[i] = ! r.used[i];
+
+  const std::vector<msh::index_t> inv = flagged (r.element, element_inverted);
+  const std::vector<msh::index_t> deg
+    = flagged (r.element, element_degenerate);
+  const std::vector<msh::index_t> unu = flagged (unused, 1);
+
+  octave_scalar_map info;
+  info.setfield ("inverted", msh::one_based (inv));
+  info.setfield ("degenerate", msh::one_based (deg));
+  NDArray dmat = msh::one_based (dup);
+  dmat.resize (dim_vector (2, dup.size () / 2));
+  info.setfield ("duplicate", dmat);
+  info.setfield ("unused", msh::one_based (unu));
+  NDArray nmat = msh::one_based (r.nonmanifold);
+  nmat.resize (dim_vector (dim, r.nonmanifold.size () / dim));
+  info.setfield ("nonmanifold", nmat);
+  info.setfield ("valid", inv.empty () && deg.empty () && dup.empty ()
+                 && unu.empty () && r.nonmanifold.empty ());
+  retval(0) = info;
+
+  if (nargout > 1)
+    {
+      NDArray p2, e2, t2;
+      repair_mesh (dim, mesh.p (), mesh.e (), mesh.t (), r.rep, p2, e2, t2);
+      retval(1) = mesh.compact ()
+                  ? msh::compact_mesh (p2, e2, t2, "mshm_check")
+                  : msh::make_mesh (p2, e2, t2);
+    }
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! info = mshm_check (mesh);
+%! assert (info.valid)
+%! assert (isempty (info.inverted) && isempty (info.duplicate))
+%! [info, mesh2] = mshm_check (mshm_compact (mesh));
+%! assert (info.valid)
+%! mesh2 = mshm_expand (mesh2);
+%! assert (mesh2.p, mesh.p)
+%! assert (mesh2.t, mesh.t)
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! mesh.t([1 2],[3 7]) = mesh.t([2 1],[3 7]);
+%! mesh.p(:,end+1) = [5; 5; 5];
+%! [info, mesh2] = mshm_check (mesh);
+%! assert (info.inverted, [3; 7])
+%! assert (info.unused, columns (mesh.p))
+%! assert (! info.valid)
+%! assert (all (msh3m_geometrical_properties (mesh2, "wjacdet")(:) > 0))
+%! assert (columns (mesh2.p), columns (mesh.p) - 1)
+%! assert (mshm_check (mesh2).valid)
+
+%!test
+%! m1 = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4);
+%! m2 = msh2m_structured_mesh (1:.5:2, 0:.5:1, 2, 5:8);
+%! np1 = columns (m1.p);
+%! mesh.p = [m1.p m2.p];
+%! mesh.t = [m1.t [m2.t(1:3,:) + np1; m2.t(4,:)]];
+%! mesh.e = [m1.e [m2.e(1:2,:) + np1; m2.e(3:end,:)]];
+%! [info, mesh2] = mshm_check (mesh);
+%! assert (info.duplicate, [np1 + (1:3); np1 - 2:np1])
+%! assert (info.valid, false)
+%! assert (columns (mesh2.p), columns (mesh.p) - 3)
+%! assert (columns (mesh2.t), columns (mesh.t))
+%! assert (mshm_check (mesh2).valid)
+%! assert (sum (msh2m_geometrical_properties (mesh2, "area")), 2, 1e-12)
+
+%!test
+%! mesh.p = [0 1 0 0 1; 0 0 1 -1 1];
+%! mesh.t = [1 2 3 1; 2 1 4 1; 1 2 5 1]';
+%! mesh.e = zeros (7, 0);
+%! [info, mesh2] = mshm_check (mesh);
+%! assert (info.nonmanifold, [1; 2])
+%! assert (isempty (info.inverted) && isempty (info.degenerate))
+%! assert (mesh2.t, mesh.t)
+
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4);
+%! mesh.t([1 2],:) = mesh.t([2 1],:);
+%! [info, mesh2] = mshm_check (mesh);
+%! assert (info.valid)
+%! assert (mesh2.t, mesh.t)
+%! cw = mesh.t;
+%! mesh.t([1 2],[2 5]) = mesh.t([2 1],[2 5]);
+%! [info, mesh2] = mshm_check (mesh);
+%! assert (info.inverted, [2; 5])
+%! assert (mesh2.t, cw)
+
+%!test
+%! ## Node 4 is within tol of node 5 only, which is within tol of node 1.
+%! mesh.p = [0 1 0 2e-11 1e-11; 0 0 1 0 0];
+%! mesh.t = [1 2 3 1]';
+%! mesh.e = zeros (7, 0);
+%! info = mshm_check (mesh, "tol", 1.5e-11);
+%! assert (info.duplicate, [4 5; 1 1])
+
+%!error <TOL> mshm_check (msh2m_structured_mesh (0:1, 0:1, 1, 1:4), "tol", -1)
+*/
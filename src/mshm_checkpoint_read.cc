@@ -0,0 +1,127 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "msh_checkpoint.h"
+#include "msh_octave.h"
+
+// Columns c0 ... c1-1 of the section called field.
+static NDArray
+read_section (msh::checkpoint::reader& r, const std::string& file,
+              const std::string& field, msh::index_t c0, msh::index_t c1)
+{
+  const msh::checkpoint::section *s = r.find (field);
+  if (! s)
+    error ("mshm_checkpoint_read: %s has no field %s", file.c_str (),
+           field.c_str ());
+  if (c1 < 0)
+    c1 = s->cols;
+  if (c0 < 0 || c0 > c1 || c1 > msh::index_t (s->cols))
+    error ("mshm_checkpoint_read: field %s has only %ld columns",
+           field.c_str (), static_cast<long> (s->cols));
+
+  NDArray a (dim_vector (s->rows, c1 - c0));
+  if (! r.read (*s, c0, c1, a.fortran_vec ()))
+    error ("mshm_checkpoint_read: error reading %s", file.c_str ());
+  return a;
+}
+
+DEFUN_DLD (mshm_checkpoint_read, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{mesh}]} = \
+mshm_checkpoint_read (@var{filename})\n\
+@deftypefnx {Function File} {[@var{a}]} = \
+mshm_checkpoint_read (@var{filename}, @var{field})\n\
+@deftypefnx {Function File} {[@var{a}]} = \
+mshm_checkpoint_read (@var{filename}, @var{field}, @var{range})\n\
+Read a mesh from a checkpoint file written by \
+@code{mshm_checkpoint_write}.\n\
+\n\
+With one argument, return the PDE-tool like structure @var{mesh} with \
+fields p, e and t, in the compact representation if the mesh written \
+was.  With @var{field} (one of \"p\", \"e\" and \"t\"), return only \
+that field, in the usual layout.  @var{range} = [@var{first}, \
+@var{last}] selects columns @var{first} to @var{last} of the field; \
+only the blocks of the file holding them are read and decoded, so that \
+parts of a large mesh can be read quickly.\n\
+@seealso{mshm_checkpoint_write}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 3 || ! args(0).is_string ())
+    print_usage ();
+  const std::string file = args(0).string_value ();
+
+  msh::checkpoint::reader r;
+  if (! r.open (file))
+    error ("mshm_checkpoint_read: %s is not a mesh checkpoint file",
+           file.c_str ());
+
+  if (nargin > 1)
+    {
+      if (! args(1).is_string ())
+        error ("mshm_checkpoint_read: FIELD must be a string");
+      msh::index_t c0 = 0, c1 = -1;
+      if (nargin == 3)
+        {
+          const NDArray range = args(2).array_value ();
+          if (range.numel () != 2 || range(0) != std::floor (range(0))
+              || range(1) != std::floor (range(1)))
+            error ("mshm_checkpoint_read: RANGE must be a pair of integers");
+          c0 = static_cast<msh::index_t> (range(0)) - 1;
+          c1 = std::max (c0, static_cast<msh::index_t> (range(1)));
+        }
+      retval(0) = read_section (r, file, args(1).string_value (), c0, c1);
+      return retval;
+    }
+
+  const NDArray p = read_section (r, file, "p", 0, -1);
+  const NDArray e = read_section (r, file, "e", 0, -1);
+  const NDArray t = read_section (r, file, "t", 0, -1);
+  if (r.find ("compact"))
+    retval(0) = msh::compact_mesh (p, e, t, "mshm_checkpoint_read");
+  else
+    retval(0) = msh::make_mesh (p, e, t);
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (0:.01:1, 0:.1:1, 1, 1:4);
+%! name = tempname ();
+%! unwind_protect
+%!   mshm_checkpoint_write (mesh, name);
+%!   t = mshm_checkpoint_read (name, "t", [15 1020]);
+%!   p = mshm_checkpoint_read (name, "p");
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+%! assert (t, mesh.t(:,15:1020))
+%! assert (p, mesh.p)
+
+%!error <not a mesh checkpoint> mshm_checkpoint_read (which ("mshm_checkpoint_read"))
+*/
@@ -0,0 +1,264 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "msh_checkpoint.h"
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+// New number of the node numbered n, if n is one.
+static inline double
+renumber (const std::vector<msh::index_t>& node, double n)
+{
+  return n >= 1 && n <= node.size ()
+    ? node[static_cast<std::size_t> (n) - 1] + 1 : n;
+}
+
+// Renumber the nodes and elements of the mesh (p, e, t) for locality,
+// and sort e by the lowest new number of its nodes.  As in
+// msh::compact_mesh, the rows of t other than dim+2 and the rows of e
+// before dim+1 or after the standard ones hold node numbers.
+static void
+reorder_mesh (int dim, NDArray& p, NDArray& e, NDArray& t)
+{
+  msh::mesh_view<double> m;
+  m.dim = dim;
+  m.np = p.cols ();
+  m.ne = e.cols ();
+  m.nt = t.cols ();
+  m.p = p.data ();
+  m.e = e.data ();
+  m.t = t.data ();
+  m.erows = e.rows ();
+  m.trows = t.rows ();
+  m.set_inline_tags ();
+
+  std::vector<msh::index_t> elem, node;
+  msh::locality_order (m, elem, node);
+
+  const msh::index_t np = m.np, ne = m.ne, nt = m.nt;
+  const msh::index_t erows = m.erows, trows = m.trows;
+  const msh::index_t nlabel = msh::standard_erows (dim);
+  NDArray p2 (p.dims ()), t2 (t.dims ()), e2 (e.dims ());
+  double *p2v = p2.fortran_vec (), *t2v = t2.fortran_vec ();
+  double *e2v = e2.fortran_vec ();
+  const double *pv = m.p, *tv = m.t, *ev = m.e;
+
+#pragma omp parallel for
+  for (msh::index_t i = 0; i < np; ++i)
+    std::copy (pv + dim * i, pv + dim * (i + 1), p2v + dim * node[i]);
+
+#pragma omp parallel for
+  for (msh::index_t k = 0; k < nt; ++k)
+    {
+      const double *src = tv + trows * elem[k];
+      double *dst = t2v + trows * k;
+      for (msh::index_t r = 0; r < trows; ++r)
+        dst[r] = r != dim + 1 ? renumber (node, src[r]) : src[r];
+    }
+
+  std::vector<std::pair<msh::index_t, msh::index_t> > key (ne);
+#pragma omp parallel for
+  for (msh::index_t j = 0; j < ne; ++j)
+    {
+      msh::index_t lo = np;
+      for (int a = 0; a < dim; ++a)
+        lo = std::min (lo, node[m.ev (a, j)]);
+      key[j] = std::make_pair (lo, j);
+    }
+  std::sort (key.begin (), key.end ());
+
+#pragma omp parallel for
+  for (msh::index_t k = 0; k < ne; ++k)
+    {
+      const double *src = ev + erows * key[k].second;
+      double *dst = e2v + erows * k;
+      for (msh::index_t r = 0; r < erows; ++r)
+        dst[r] = r < dim || r >= nlabel ? renumber (node, src[r]) : src[r];
+    }
+
+  p = p2;
+  e = e2;
+  t = t2;
+}
+
+DEFUN_DLD (mshm_checkpoint_write, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {} mshm_checkpoint_write (@var{mesh}, \
+@var{filename})\n\
+@deftypefnx {Function File} {} mshm_checkpoint_write (@var{mesh}, \
+@var{filename}, @var{property}, @var{value}, @dots{})\n\
+Write @var{mesh} to the binary checkpoint file @var{filename}.\n\
+\n\
+The fields p, e and t of @var{mesh} are stored in blocks of columns, \
+which are encoded and compressed in parallel and can be read back \
+separately by @code{mshm_checkpoint_read}.  Node numbers and other \
+integer rows are stored as varint encoded differences between \
+consecutive columns and coordinates by the bits of their differences, \
+so that the file is usually several times smaller than the gmsh or \
+dolfin formats.  Blocks are compressed with zlib if the package was \
+built with it.  Meshes in the compact representation built by \
+@code{mshm_compact} are read back in the same representation.\n\
+\n\
+The following properties can be set:\n\
+@table @asis\n\
+@item \"reorder\"\n\
+if true, renumber the elements along a Morton curve through their \
+centers and the nodes in order of appearance in the elements before \
+writing, which makes the differences between node numbers small; the \
+mesh read back is then numbered in this order (default false);\n\
+@item \"quantize\"\n\
+if positive, store the coordinates as the nearest multiples of this \
+step (relative to their minimum) and the difference of their bits from \
+those of that multiple; this is lossless, and makes the file smaller \
+if the coordinates lie on or near such a grid, e.g. 0.01 for \
+coordinates given to two decimal places (default 0, store the bits of \
+the coordinates); a coordinate with NaN or infinite values is always \
+stored as bits;\n\
+@item \"level\"\n\
+zlib compression level, from 0 (no compression) to 9 (default 1).\n\
+@end table\n\
+@seealso{mshm_checkpoint_read, mshm_compact, msh2m_gmsh_write, \
+mshm_dolfin_write}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin % 2 != 0)
+    print_usage ();
+
+  msh::octave_mesh mesh (args(0), "mshm_checkpoint_write");
+  if (! args(1).is_string ())
+    error ("mshm_checkpoint_write: FILENAME must be a string");
+  const std::string name = args(1).string_value ();
+
+  bool reorder = false;
+  double step = 0;
+  int level = 1;
+  for (int nn = 2; nn < nargin; nn += 2)
+    {
+      if (! args(nn).is_string ())
+        error ("mshm_checkpoint_write: only string value admitted for "
+               "properties.");
+      std::string prop = args(nn).string_value ();
+      if (! ((args(nn+1).isnumeric () || args(nn+1).islogical ())
+             && args(nn+1).numel () == 1))
+        error ("mshm_checkpoint_write: the value of %s must be a scalar",
+               prop.c_str ());
+      double val = args(nn+1).double_value ();
+      if (prop == "reorder")
+        reorder = val != 0;
+      else if (prop == "quantize" && val >= 0)
+        step = val;
+      else if (prop == "level" && val >= 0 && val <= 9)
+        level = static_cast<int> (val);
+      else
+        error ("mshm_checkpoint_write: invalid property or value: %s",
+               prop.c_str ());
+    }
+
+  const int dim = mesh.dim ();
+  NDArray p = mesh.p (), e = mesh.e (), t = mesh.t ();
+  if (reorder)
+    reorder_mesh (dim, p, e, t);
+
+  msh::checkpoint::writer w;
+  if (! w.open (name, level))
+    error ("mshm_checkpoint_write: cannot open %s for writing",
+           name.c_str ());
+  w.add ("p", p.data (), dim, p.cols (), step);
+  w.add ("e", e.data (), e.rows (), e.cols ());
+  w.add ("t", t.data (), t.rows (), t.cols ());
+  if (mesh.compact ())
+    w.add ("compact", 0, 0, 0);
+  if (! w.close ())
+    error ("mshm_checkpoint_write: error writing %s", name.c_str ());
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (linspace (0, 1, 41), linspace (0, 1, 31), 1, 1:4);
+%! name = tempname ();
+%! unwind_protect
+%!   mshm_checkpoint_write (mesh, name);
+%!   mesh2 = mshm_checkpoint_read (name);
+%!   info = dir (name);
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+%! assert (mesh2.p, mesh.p)
+%! assert (mesh2.e, mesh.e)
+%! assert (mesh2.t, mesh.t)
+%! assert (info.bytes < 8 * (numel (mesh.p) + numel (mesh.e) + numel (mesh.t)) / 4)
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.25:1, 0:.25:1, 0:.5:1, 1, 1:6);
+%! name = tempname ();
+%! unwind_protect
+%!   mshm_checkpoint_write (mesh, name, "reorder", true);
+%!   mesh2 = mshm_checkpoint_read (name);
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+%! assert (sortrows (mesh2.p'), sortrows (mesh.p'))
+%! vol = msh3m_geometrical_properties (mesh2, "area");
+%! assert (sum (vol), 1, 1e-12)
+%! assert (all (vol > 0))
+%! assert (sort (mesh2.e(10,:)), sort (mesh.e(10,:)))
+%! [~, i] = sortrows (mesh.p');
+%! [~, i2] = sortrows (mesh2.p');
+%! perm(i) = i2;
+%! assert (sortrows (sort (perm(mesh.t(1:4,:)))'), sortrows (sort (mesh2.t(1:4,:))'))
+
+%!test
+%! mesh = mshm_compact (msh2m_structured_mesh (0:.1:1, 0:.1:1, 2, 1:4));
+%! name = tempname ();
+%! unwind_protect
+%!   mshm_checkpoint_write (mesh, name, "quantize", .05);
+%!   mesh2 = mshm_checkpoint_read (name);
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+%! assert (class (mesh2.t), "int32")
+%! assert (mesh2.t, mesh.t)
+%! assert (mesh2.p, mesh.p)
+
+%!test
+%! mesh = msh2m_structured_mesh (0:.1:1, 0:.1:1, 1, 1:4);
+%! mesh.p(1,[3 7]) = NaN;
+%! name = tempname ();
+%! unwind_protect
+%!   mshm_checkpoint_write (mesh, name, "quantize", .05);
+%!   p = mshm_checkpoint_read (name, "p");
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+%! assert (p, mesh.p)
+
+%!error <invalid property> mshm_checkpoint_write (msh2m_structured_mesh (0:1, 0:1, 1, 1:4), tempname (), "level", 10)
+*/
@@ -0,0 +1,123 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+DEFUN_DLD (mshm_compact, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{cmesh}]} = mshm_compact (@var{mesh})\n\
+Convert a mesh to a compact representation using integer arrays for \
+the connectivity and the tags.\n\
+\n\
+The fields of @var{cmesh} are:\n\
+@table @asis\n\
+@item p\n\
+the node coordinates, unchanged;\n\
+@item t\n\
+an int32 matrix with the rows of @var{mesh}.t holding node numbers, \
+that is all the rows except the region number;\n\
+@item tregion\n\
+the region numbers of the elements, as a row vector;\n\
+@item e\n\
+an int32 matrix with the rows of @var{mesh}.e holding node numbers: \
+the vertices of the sides (rows 1 to 2 in 2D, 1 to 3 in 3D) followed by \
+the rows after the tags, if any (e.g. the mid-edge nodes added by \
+@code{mshm_promote_p2});\n\
+@item etags\n\
+the rows of tags of @var{mesh}.e (rows 3 to 7 in 2D, 4 to 10 in 3D) \
+which are not zero for every side;\n\
+@item etagrows\n\
+the numbers of the rows of @var{mesh}.e stored in @var{cmesh}.etags;\n\
+@item erows\n\
+the number of node and tag rows of @var{mesh}.e.\n\
+@end table\n\
+The tags are stored as int16 if they all fit in that type, as int32 \
+otherwise, and must be integers.  The other fields of @var{mesh} are \
+copied unchanged.  Compact meshes take roughly half the memory of the \
+usual ones.  They are accepted by the compiled functions of the \
+package which take a mesh, whose results are compact when their input \
+is.  @code{mshm_octree_mesh}, @code{mshm_gmsh} and \
+@code{mshm_dolfin_read} return compact meshes with the option \
+\"compact\", and @code{mshm_checkpoint_read} does if the mesh written \
+was compact; these build the usual arrays first, so that only the \
+memory held by the result is reduced.  The other generators, and all \
+the m-file functions, need the usual representation, which \
+@code{mshm_expand} gives back.  If @var{mesh} is already compact it is \
+returned unchanged.\n\
+@seealso{mshm_expand, mshm_octree_mesh, mshm_gmsh, mshm_dolfin_read}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  if (args.length () != 1)
+    print_usage ();
+
+  msh::octave_mesh mesh (args(0), "mshm_compact");
+  if (mesh.compact ())
+    retval(0) = args(0);
+  else
+    {
+      octave_scalar_map a = args(0).scalar_map_value ();
+      octave_scalar_map c = msh::compact_mesh (mesh.p (), mesh.e (),
+                                               mesh.t (), "mshm_compact");
+      for (octave_scalar_map::const_iterator it = c.begin ();
+           it != c.end (); ++it)
+        a.setfield (c.key (it), c.contents (it));
+      retval(0) = a;
+    }
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4);
+%! cmesh = mshm_compact (mesh);
+%! assert (class (cmesh.t), "int32")
+%! assert (class (cmesh.e), "int32")
+%! assert (class (cmesh.tregion), "int16")
+%! assert (size (cmesh.t), [3 8])
+%! assert (cmesh.etagrows, [5 7])
+%! assert (cmesh.erows, 7)
+%! assert (double (cmesh.etags), mesh.e([5 7],:))
+%! assert (mshm_expand (cmesh), mesh)
+%! assert (mshm_compact (cmesh), cmesh)
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 70000, 1:6);
+%! cmesh = mshm_compact (mesh);
+%! assert (class (cmesh.tregion), "int32")
+%! assert (cmesh.etagrows, [9 10])
+%! assert (mshm_expand (cmesh), mesh)
+
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4);
+%! cmesh = mshm_compact (mesh);
+%! assert (mshm_expand (mshm_promote_p2 (cmesh)), mshm_promote_p2 (mesh))
+%! [area, shg] = mshm_batch ("geometrical_properties", {cmesh}, "area", "shg");
+%! assert (area{1}, msh2m_geometrical_properties (mesh, "area"), 1e-12)
+%! assert (shg{1}, msh2m_geometrical_properties (mesh, "shg"), 1e-12)
+%! cmesh2 = mshm_remesh (cmesh, .3 * ones (1, columns (mesh.p)));
+%! assert (class (cmesh2.t), "int32")
+
+%!error <not a valid mesh> mshm_compact (1)
+*/
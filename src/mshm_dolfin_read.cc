@@ -0,0 +1,339 @@
+/* Copyright (C) 2013-14 Marco Vassallo
+   Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+#include "msh_xml.h"
+
+typedef std::pair<msh::index_t, double> facet_marker;
+
+// Arrays filled while the file is parsed; facet markers are keyed by
+// (dim+1)*cell+local_entity.
+struct dolfin_mesh
+{
+  int dim;
+  NDArray p, t;
+  std::vector<facet_marker> markers;
+};
+
+static void
+parse_error (const std::string& file, const msh::xml_reader& xml,
+             const char *what)
+{
+  error ("mshm_dolfin_read: %s, line %ld: %s", file.c_str (), xml.line (),
+         what);
+}
+
+static msh::index_t
+index_attribute (const std::string& file, const msh::xml_reader& xml,
+                 const char *key, msh::index_t n)
+{
+  bool ok = true;
+  const double v = xml.number (key, ok);
+  if (! ok || v < 0 || v >= n || v != std::floor (v))
+    parse_error (file, xml, (std::string ("invalid ") + key).c_str ());
+  return static_cast<msh::index_t> (v);
+}
+
+static void
+parse_dolfin (const std::string& file, dolfin_mesh& m)
+{
+  msh::stream_file f;
+  if (! f.open (file, "rb"))
+    error ("mshm_dolfin_read: cannot open %s", file.c_str ());
+
+  static const char *coords[3] = {"x", "y", "z"};
+  static const char *verts[4] = {"v0", "v1", "v2", "v3"};
+  msh::xml_reader xml (f);
+  m.dim = 0;
+  msh::index_t np = -1, nt = -1, nv = 0, nc = 0;
+  std::vector<bool> seen_p, seen_t;
+  int collection = -1;
+  bool ok = true;
+  std::string cell_name;
+
+  for (msh::xml_reader::event ev = xml.next ();
+       ev != msh::xml_reader::end_of_file; ev = xml.next ())
+    {
+      if (ev == msh::xml_reader::syntax_error)
+        parse_error (file, xml, "malformed XML");
+      const std::string& tag = xml.name ();
+      if (ev == msh::xml_reader::end_tag)
+        {
+          if (tag == "mesh_value_collection")
+            collection = -1;
+          continue;
+        }
+
+      if (tag == "mesh")
+        {
+          const char *type = xml.attribute ("celltype");
+          const std::string celltype = type ? type : "";
+          m.dim = celltype == "triangle" ? 2
+                  : celltype == "tetrahedron" ? 3 : 0;
+          if (m.dim == 0)
+            parse_error (file, xml, "only triangle and tetrahedron meshes "
+                         "are supported");
+          if (xml.number ("dim", ok) != m.dim)
+            parse_error (file, xml, "only meshes with the same geometric "
+                         "and topological dimension are supported");
+          cell_name = celltype;
+        }
+      else if (m.dim == 0)
+        continue;
+      else if (tag == "vertices")
+        {
+          np = index_attribute (file, xml, "size", 1e15);
+          m.p = NDArray (dim_vector (m.dim, np));
+          seen_p.assign (np, false);
+        }
+      else if (tag == "vertex")
+        {
+          if (np < 0)
+            parse_error (file, xml, "vertex outside of vertices");
+          const msh::index_t i = index_attribute (file, xml, "index", np);
+          if (seen_p[i])
+            parse_error (file, xml, "repeated vertex index");
+          seen_p[i] = true;
+          for (int d = 0; d < m.dim; ++d)
+            m.p(d, i) = xml.number (coords[d], ok);
+          ++nv;
+        }
+      else if (tag == "cells")
+        {
+          nt = index_attribute (file, xml, "size", 1e15);
+          m.t = NDArray (dim_vector (m.dim + 2, nt), 1.0);
+          seen_t.assign (nt, false);
+        }
+      else if (tag == cell_name)
+        {
+          if (nt < 0 || np < 0)
+            parse_error (file, xml, "cell outside of cells");
+          const msh::index_t j = index_attribute (file, xml, "index", nt);
+          if (seen_t[j])
+            parse_error (file, xml, "repeated cell index");
+          seen_t[j] = true;
+          for (int k = 0; k <= m.dim; ++k)
+            m.t(k, j) = index_attribute (file, xml, verts[k], np) + 1;
+          ++nc;
+        }
+      else if (tag == "mesh_value_collection")
+        collection = static_cast<int> (xml.number ("dim", ok));
+      else if (tag == "value" && (collection == m.dim
+                                  || collection == m.dim - 1))
+        {
+          if (nt < 0)
+            parse_error (file, xml, "marker before cells");
+          const msh::index_t j = index_attribute (file, xml, "cell_index",
+                                                  nt);
+          const double value = xml.number ("value", ok);
+          if (collection == m.dim)
+            m.t(m.dim + 1, j) = value;
+          else
+            {
+              const msh::index_t k = index_attribute (file, xml,
+                                                      "local_entity",
+                                                      m.dim + 1);
+              m.markers.push_back (facet_marker ((m.dim + 1) * j + k, value));
+            }
+        }
+
+      if (! ok)
+        parse_error (file, xml, "missing or invalid attribute");
+    }
+
+  if (m.dim == 0)
+    error ("mshm_dolfin_read: %s contains no mesh", file.c_str ());
+  if (nv != np || nc != nt)
+    error ("mshm_dolfin_read: %s: the number of vertices or cells does not "
+           "match the declared size", file.c_str ());
+}
+
+DEFUN_DLD (mshm_dolfin_read, args, ,"-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{mesh}]} = \
+mshm_dolfin_read (@var{mesh_to_read}) \n\
+@deftypefnx {Function File} {[@var{mesh}]} = \
+mshm_dolfin_read (@var{mesh_to_read}, \"compact\", @var{tf})\n\
+Read a mesh from a dolfin .xml or .xml.gz file.\n\
+The string @var{mesh_to_read} should be the name of the \
+mesh file to be read.\n\
+The output @var{mesh} is a PDE-tool like structure\n\
+with matrix fields (p,e,t).\n\
+\n\
+The file is parsed as a stream, directly into p and t, and does not \
+need FEniCS.  The region numbers in t are read from the cell markers \
+in the domains section of the file (1 if absent).  The columns of e are \
+the facets belonging to a single cell, with the facet markers as side \
+(in 2D) or face (in 3D) numbers (0 if absent) and the region of that \
+cell.  Compressed files can be read if the package was built with \
+zlib.  If @var{tf} is true, @var{mesh} is returned in the compact \
+representation of @code{mshm_compact}.\n\
+@seealso{msh3m_structured_mesh, msh2m_structured_mesh, mshm_dolfin_write}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  const int nargin = args.length ();
+  if ((nargin != 1 && nargin != 3) || ! args(0).is_string ())
+    print_usage ();
+  const std::string file = args(0).string_value ();
+  bool compact = false;
+  if (nargin == 3)
+    {
+      if (! args(1).is_string () || args(1).string_value () != "compact"
+          || args(2).numel () != 1
+          || ! (args(2).islogical () || args(2).isnumeric ()))
+        error ("mshm_dolfin_read: the only option is \"compact\", true or "
+               "false");
+      compact = args(2).bool_value ();
+    }
+
+  dolfin_mesh dm;
+  parse_dolfin (file, dm);
+  const int dim = dm.dim, nlf = dim + 1;
+  std::sort (dm.markers.begin (), dm.markers.end ());
+
+  msh::mesh_view<double> m;
+  m.dim = dim;
+  m.np = dm.p.cols ();
+  m.ne = 0;
+  m.nt = dm.t.cols ();
+  m.p = dm.p.data ();
+  m.e = 0;
+  m.t = dm.t.data ();
+  m.erows = 0;
+  m.trows = dim + 2;
+  m.set_inline_tags ();
+
+  std::vector<msh::index_t> ext;
+  msh::exterior_facets (m, ext);
+  const msh::index_t ne = ext.size (), erows = msh::standard_erows (dim);
+  NDArray e (dim_vector (erows, ne), 0.0);
+  double *evec = e.fortran_vec ();
+#pragma omp parallel for
+  for (msh::index_t q = 0; q < ne; ++q)
+    {
+      const msh::index_t j = ext[q] / nlf;
+      const int *lf = msh::local_facet (dim, ext[q] % nlf);
+      double *eq = evec + erows * q;
+      for (int a = 0; a < dim; ++a)
+        eq[a] = m.tv (lf[a], j) + 1;
+
+      std::vector<facet_marker>::const_iterator it
+        = std::lower_bound (dm.markers.begin (), dm.markers.end (),
+                            facet_marker (ext[q], -HUGE_VAL));
+      if (it != dm.markers.end () && it->first == ext[q])
+        eq[msh::label_row (dim)] = it->second;
+      eq[dim == 2 ? 6 : 8] = m.region (j);
+    }
+
+  retval(0) = compact ? msh::compact_mesh (dm.p, e, dm.t, "mshm_dolfin_read")
+                     : msh::make_mesh (dm.p, e, dm.t);
+  return retval;
+}
+
+/*
+%!test
+%! x = y = z = linspace (0, 1, 3);
+%! msh = msh3m_structured_mesh (x, y, z, 2, [1 : 6]);
+%! name = [tempname() ".xml"];
+%! unwind_protect
+%!   mshm_dolfin_write (msh, name);
+%!   msh2 = mshm_dolfin_read (name);
+%!   cmsh2 = mshm_dolfin_read (name, "compact", true);
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+%! assert (msh2.p, msh.p)
+%! assert (msh2.t, [sort(msh.t(1:4,:)); msh.t(5,:)])
+%! key = @(e) sortrows ([sort(e(1:3,:))' e(9:10,:)']);
+%! assert (key (msh2.e), key (msh.e))
+%! assert (mshm_expand (cmsh2), msh2)
+
+%!test
+%! msh = msh2m_structured_mesh (0:.25:1, 0:.5:1, 3, [4 3 2 1], "left");
+%! msh.t(4,1:2:end) = 5;
+%! name = [tempname() ".xml.gz"];
+%! unwind_protect
+%!   try
+%!     mshm_dolfin_write (msh, name);
+%!   catch err
+%!     if (strcmp (err.identifier, "msh:no-zlib"))
+%!       return;
+%!     endif
+%!     rethrow (err);
+%!   end_try_catch
+%!   msh2 = mshm_dolfin_read (name);
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+%! assert (msh2.p, msh.p)
+%! assert (msh2.t, [sort(msh.t(1:3,:)); msh.t(4,:)])
+%! key = @(e) sortrows ([sort(e(1:2,:))' e(5,:)']);
+%! assert (key (msh2.e), key (msh.e))
+
+%!test
+%! name = [tempname() ".xml"];
+%! fid = fopen (name, "w");
+%! fprintf (fid, "<?xml version=\"1.0\"?>\n<!-- a comment -->\n");
+%! fprintf (fid, "<dolfin xmlns:dolfin=\"http://fenicsproject.org\">\n");
+%! fprintf (fid, "  <mesh celltype=\"triangle\" dim=\"2\">\n");
+%! fprintf (fid, "    <vertices size=\"4\">\n");
+%! fprintf (fid, "      <vertex index=\"%d\" x=\"%g\" y=\"%g\"/>\n", [0:3; 0 1 0 1; 0 0 1 1]);
+%! fprintf (fid, "    </vertices>\n    <cells size=\"2\">\n");
+%! fprintf (fid, "      <triangle index=\"0\" v0=\"0\" v1=\"1\" v2=\"2\" />\n");
+%! fprintf (fid, "      <triangle index='1' v0='1' v1='2' v2='3' />\n");
+%! fprintf (fid, "    </cells>\n  </mesh>\n</dolfin>\n");
+%! fclose (fid);
+%! unwind_protect
+%!   msh = mshm_dolfin_read (name);
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+%! assert (msh.p, [0 1 0 1; 0 0 1 1])
+%! assert (msh.t, [1 2; 2 3; 3 4; 1 1])
+%! assert (columns (msh.e), 4)
+%! assert (msh.e(5,:), zeros (1, 4))
+%! assert (msh.e(7,:), ones (1, 4))
+
+%!error <repeated vertex index>
+%! name = [tempname() ".xml"];
+%! fid = fopen (name, "w");
+%! fprintf (fid, "<dolfin>\n  <mesh celltype=\"triangle\" dim=\"2\">\n");
+%! fprintf (fid, "    <vertices size=\"3\">\n");
+%! fprintf (fid, "      <vertex index=\"%d\" x=\"%g\" y=\"%g\"/>\n", [0 1 1; 0 1 1; 0 0 1]);
+%! fprintf (fid, "    </vertices>\n  </mesh>\n</dolfin>\n");
+%! fclose (fid);
+%! unwind_protect
+%!   mshm_dolfin_read (name);
+%! unwind_protect_cleanup
+%!   unlink (name);
+%! end_unwind_protect
+
+%!error <cannot open> mshm_dolfin_read ("no_such_file.xml")
+*/
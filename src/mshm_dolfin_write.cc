@@ -0,0 +1,295 @@
+/* Copyright (C) 2013-14 Marco Vassallo
+   Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+#include "msh_xml.h"
+
+// Text is formatted into a buffer which is written out when full.
+class xml_writer
+{
+public:
+
+  xml_writer (msh::stream_file& f) : m_file (f), m_ok (true)
+  { m_buf.reserve (1 << 17); }
+
+  void
+  put (const char *s, int n)
+  {
+    m_buf.append (s, n);
+    if (m_buf.size () >= (1 << 17))
+      flush ();
+  }
+
+  void put (const std::string& s) { put (s.data (), s.size ()); }
+
+  bool
+  flush (void)
+  {
+    m_ok = m_file.write (m_buf.data (), m_buf.size ()) && m_ok;
+    m_buf.clear ();
+    return m_ok;
+  }
+
+private:
+
+  msh::stream_file& m_file;
+  std::string m_buf;
+  bool m_ok;
+};
+
+// Vertices of element j in increasing order, as required by dolfin.
+template <typename T>
+static void
+sorted_cell (const msh::mesh_view<T>& m, msh::index_t j, msh::index_t *v)
+{
+  for (int k = 0; k <= m.dim; ++k)
+    v[k] = m.tv (k, j);
+  std::sort (v, v + m.dim + 1);
+}
+
+static bool
+is_marker (double x)
+{
+  return x >= 0 && x == std::floor (x) && x < 4294967296.0;
+}
+
+template <typename T>
+static bool
+write_dolfin (const msh::mesh_view<T>& m,
+              const std::vector<msh::index_t>& facet, xml_writer& out)
+{
+  static const char *cells[4] = {0, 0, "triangle", "tetrahedron"};
+  char line[256];
+  msh::index_t v[4];
+  const int dim = m.dim, lrow = msh::label_row (dim);
+
+  int n = std::snprintf (line, sizeof (line),
+                         "<?xml version=\"1.0\"?>\n"
+                         "<dolfin xmlns:dolfin=\"http://fenicsproject.org\">"
+                         "\n  <mesh celltype=\"%s\" dim=\"%d\">\n"
+                         "    <vertices size=\"%ld\">\n",
+                         cells[dim], dim, static_cast<long> (m.np));
+  out.put (line, n);
+  for (msh::index_t i = 0; i < m.np; ++i)
+    {
+      const double *x = m.point (i);
+      n = dim == 2
+        ? std::snprintf (line, sizeof (line), "      <vertex index=\"%ld\" "
+                         "x=\"%.17g\" y=\"%.17g\" />\n",
+                         static_cast<long> (i), x[0], x[1])
+        : std::snprintf (line, sizeof (line), "      <vertex index=\"%ld\" "
+                         "x=\"%.17g\" y=\"%.17g\" z=\"%.17g\" />\n",
+                         static_cast<long> (i), x[0], x[1], x[2]);
+      out.put (line, n);
+    }
+
+  n = std::snprintf (line, sizeof (line),
+                     "    </vertices>\n    <cells size=\"%ld\">\n",
+                     static_cast<long> (m.nt));
+  out.put (line, n);
+  for (msh::index_t j = 0; j < m.nt; ++j)
+    {
+      sorted_cell (m, j, v);
+      n = std::snprintf (line, sizeof (line),
+                         "      <%s index=\"%ld\" v0=\"%ld\" v1=\"%ld\" "
+                         "v2=\"%ld\"", cells[dim], static_cast<long> (j),
+                         static_cast<long> (v[0]), static_cast<long> (v[1]),
+                         static_cast<long> (v[2]));
+      out.put (line, n);
+      n = dim == 2 ? std::snprintf (line, sizeof (line), " />\n")
+        : std::snprintf (line, sizeof (line), " v3=\"%ld\" />\n",
+                         static_cast<long> (v[3]));
+      out.put (line, n);
+    }
+  out.put ("    </cells>\n    <domains>\n");
+
+  n = std::snprintf (line, sizeof (line),
+                     "      <mesh_value_collection type=\"uint\" dim=\"%d\" "
+                     "size=\"%ld\">\n", dim, static_cast<long> (m.nt));
+  out.put (line, n);
+  for (msh::index_t j = 0; j < m.nt; ++j)
+    {
+      n = std::snprintf (line, sizeof (line),
+                         "        <value cell_index=\"%ld\" "
+                         "local_entity=\"0\" value=\"%.0f\" />\n",
+                         static_cast<long> (j), m.region (j));
+      out.put (line, n);
+    }
+  out.put ("      </mesh_value_collection>\n");
+
+  n = std::snprintf (line, sizeof (line),
+                     "      <mesh_value_collection type=\"uint\" dim=\"%d\" "
+                     "size=\"%ld\">\n", dim - 1, static_cast<long> (m.ne));
+  out.put (line, n);
+  for (msh::index_t q = 0; q < m.ne; ++q)
+    {
+      n = std::snprintf (line, sizeof (line),
+                         "        <value cell_index=\"%ld\" "
+                         "local_entity=\"%d\" value=\"%.0f\" />\n",
+                         static_cast<long> (facet[q] / (dim + 1)),
+                         static_cast<int> (facet[q] % (dim + 1)),
+                         m.elabel (lrow, q));
+      out.put (line, n);
+    }
+  out.put ("      </mesh_value_collection>\n"
+           "    </domains>\n  </mesh>\n</dolfin>\n");
+  return out.flush ();
+}
+
+// Check the markers and find the facet of each side or face, before
+// the file is opened, so that an invalid mesh leaves no file behind.
+// The facet markers refer to the cell containing each side or face
+// and to the position in that cell of the vertex opposite to it.
+template <typename T>
+static void
+find_facets (const msh::mesh_view<T>& m, std::vector<msh::index_t>& facet)
+{
+  const int dim = m.dim, lrow = msh::label_row (dim);
+  for (msh::index_t j = 0; j < m.nt; ++j)
+    if (! is_marker (m.region (j)))
+      error ("mshm_dolfin_write: the region of element %ld is not a "
+             "non-negative integer", static_cast<long> (j + 1));
+
+  msh::csr_graph v2c;
+  msh::build_v2c (m, v2c);
+  facet.assign (m.ne, -1);
+#pragma omp parallel for
+  for (msh::index_t q = 0; q < m.ne; ++q)
+    {
+      msh::index_t ve[3], vt[4];
+      for (int a = 0; a < dim; ++a)
+        ve[a] = m.ev (a, q);
+      const msh::index_t j = msh::element_with (m, v2c, ve, dim);
+      if (j < 0)
+        continue;
+      sorted_cell (m, j, vt);
+      for (int k = 0; k <= dim; ++k)
+        if (std::find (ve, ve + dim, vt[k]) == ve + dim)
+          facet[q] = (dim + 1) * j + k;
+    }
+
+  for (msh::index_t q = 0; q < m.ne; ++q)
+    {
+      if (facet[q] < 0)
+        error ("mshm_dolfin_write: side %ld of e is not a facet of any "
+               "element", static_cast<long> (q + 1));
+      if (! is_marker (m.elabel (lrow, q)))
+        error ("mshm_dolfin_write: the label of side %ld of e is not a "
+               "non-negative integer", static_cast<long> (q + 1));
+    }
+}
+
+DEFUN_DLD (mshm_dolfin_write, args, ,"-*- texinfo -*-\n\
+@deftypefn {Function File} {} mshm_dolfin_write (@var{mesh}) \n\
+@deftypefnx {Function File} {} mshm_dolfin_write (@var{mesh}, \
+@var{mesh_name}) \n\
+Write a mesh to a dolfin .xml file.\n\
+The input @var{mesh} is a PDE-tool like structure\n\
+with matrix fields (p,e,t).\n\
+The optional string @var{mesh_name} is the name of the file \
+(default \"mesh\"); the suffix .xml is appended unless it ends in .xml \
+or .xml.gz, in which case the file is compressed.\n\
+\n\
+The file is written as a stream and does not need FEniCS.  The \
+vertices of each cell are listed in increasing order, as required by \
+dolfin.  The region numbers in t and the side (in 2D) or face (in 3D) \
+numbers in e are stored as cell and facet markers in the domains \
+section of the file, and must be non-negative integers.  Compressed \
+files can be written if the package was built with zlib.\n\
+@seealso{mshm_dolfin_read, msh2m_structured_mesh, msh3m_structured_mesh}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  std::string name = "mesh";
+  if (nargin == 2)
+    {
+      if (! args(1).is_string ())
+        error ("mshm_dolfin_write: the second argument must be a string");
+      name = args(1).string_value ();
+    }
+  if (! (msh::ends_with (name, ".xml") || msh::ends_with (name, ".xml.gz")))
+    name += ".xml";
+
+  msh::octave_mesh mesh (args(0), "mshm_dolfin_write");
+  if (mesh.compact () ? mesh.cview ().trows != mesh.dim () + 2
+                      : mesh.view ().trows != mesh.dim () + 2)
+    error ("mshm_dolfin_write: the input mesh must be linear");
+  std::vector<msh::index_t> facet;
+  if (mesh.compact ())
+    find_facets (mesh.cview (), facet);
+  else
+    find_facets (mesh.view (), facet);
+
+#if ! defined (HAVE_ZLIB_H)
+  if (msh::ends_with (name, ".gz"))
+    error_with_id ("msh:no-zlib", "mshm_dolfin_write: cannot write %s, the "
+                   "package was built without zlib", name.c_str ());
+#endif
+  msh::stream_file f;
+  if (! f.open (name, "wb"))
+    error ("mshm_dolfin_write: cannot open %s for writing", name.c_str ());
+  xml_writer out (f);
+  const bool ok = mesh.compact () ? write_dolfin (mesh.cview (), facet, out)
+                                  : write_dolfin (mesh.view (), facet, out);
+  if (! (f.close () && ok))
+    error ("mshm_dolfin_write: error writing %s", name.c_str ());
+
+  return retval;
+}
+
+/*
+%!test
+%! msh = msh2m_structured_mesh (0:.5:1, 0:1, 1, 1:4);
+%! name = tempname ();
+%! unwind_protect
+%!   mshm_dolfin_write (mshm_compact (msh), name);
+%!   msh2 = mshm_dolfin_read ([name ".xml"]);
+%! unwind_protect_cleanup
+%!   unlink ([name ".xml"]);
+%! end_unwind_protect
+%! assert (msh2.p, msh.p)
+%! assert (sortrows (msh2.e([1 2 5],:)'), sortrows ([sort(msh.e(1:2,:)); msh.e(5,:)]'))
+
+%!test
+%! msh = msh2m_structured_mesh (0:1, 0:1, 1, 1:4);
+%! msh.e(5,1) = .5;
+%! name = [tempname() ".xml"];
+%! fail ("mshm_dolfin_write (msh, name)", "label of side 1");
+%! assert (! exist (name, "file"))
+
+%!error <non-negative integer>
+%! msh = msh2m_structured_mesh (0:1, 0:1, 1, 1:4);
+%! msh.t(4,:) = -1;
+%! mshm_dolfin_write (msh, [tempname() ".xml"]);
+*/
@@ -0,0 +1,67 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+DEFUN_DLD (mshm_expand, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{mesh}]} = mshm_expand (@var{cmesh})\n\
+Convert a mesh in the compact representation built by \
+@code{mshm_compact} back to the usual PDE-tool like representation.\n\
+\n\
+The tag rows of e which were dropped by @code{mshm_compact} because \
+they were zero are restored as rows of zeros.  The other fields of \
+@var{cmesh} are copied unchanged.  If @var{cmesh} is not compact it is \
+returned unchanged.\n\
+@seealso{mshm_compact}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  if (args.length () != 1)
+    print_usage ();
+
+  msh::octave_mesh mesh (args(0), "mshm_expand");
+  if (! mesh.compact ())
+    retval(0) = args(0);
+  else
+    {
+      octave_scalar_map a = args(0).scalar_map_value ();
+      a.setfield ("e", mesh.e ());
+      a.setfield ("t", mesh.t ());
+      a.rmfield ("tregion");
+      a.rmfield ("etags");
+      a.rmfield ("etagrows");
+      a.rmfield ("erows");
+      retval(0) = a;
+    }
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! mesh.e(7,:) = 3;
+%! assert (mshm_expand (mshm_compact (mesh)), mesh)
+%! assert (mshm_expand (mesh), mesh)
+*/
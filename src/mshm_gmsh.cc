@@ -0,0 +1,581 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if defined (HAVE_GMSH_H)
+#include <gmsh.h>
+#endif
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+#if defined (HAVE_GMSH_H)
+
+// Gmsh is initialized at the first call and finalized when the
+// oct-file is unloaded, so that consecutive calls share a session.
+class gmsh_session
+{
+public:
+
+  gmsh_session (void) { gmsh::initialize (0, 0, false); }
+
+  ~gmsh_session (void) { gmsh::finalize (); }
+
+  static void
+  start (void)
+  {
+    static gmsh_session session;
+#if GMSH_API_VERSION_MAJOR > 4 \
+  || (GMSH_API_VERSION_MAJOR == 4 && GMSH_API_VERSION_MINOR >= 11)
+    gmsh::option::restoreDefaults ();
+#endif
+    gmsh::clear ();
+    gmsh::option::setNumber ("General.Terminal", 0);
+  }
+};
+
+#endif
+
+// A gmsh option to be set before meshing, either numeric or a string.
+struct gmsh_option
+{
+  std::string name;
+  bool is_string;
+  double number;
+  std::string string;
+};
+
+// Command line options of gmsh accepted by msh2m_gmsh and msh3m_gmsh,
+// and the corresponding option names.
+static const char *cli_options[][2] =
+{
+  {"clscale", "Mesh.MeshSizeFactor"},
+  {"clmin", "Mesh.MeshSizeMin"},
+  {"clmax", "Mesh.MeshSizeMax"},
+  {"clcurv", "Mesh.MeshSizeFromCurvature"},
+  {"rand", "Mesh.RandomFactor"},
+  {"smooth", "Mesh.Smoothing"},
+  {"optimize", "Mesh.Optimize"},
+  {"optimize_netgen", "Mesh.OptimizeNetgen"},
+  {"nt", "General.NumThreads"},
+  {"v", "General.Verbosity"}
+};
+
+// Values of -algo, for 2D (Mesh.Algorithm) and 3D (Mesh.Algorithm3D).
+static const struct { const char *name; int dim, value; } algorithms[] =
+{
+  {"meshadapt", 2, 1}, {"auto", 2, 2}, {"del2d", 2, 5}, {"front2d", 2, 6},
+  {"delquad", 2, 8}, {"pack", 2, 9}, {"quadqs", 2, 11},
+  {"del3d", 3, 1}, {"front3d", 3, 4}, {"mmg3d", 3, 7}, {"hxt", 3, 10}
+};
+
+static gmsh_option
+parse_option (const std::string& flag, const octave_value& val)
+{
+  gmsh_option opt;
+  opt.is_string = val.is_string ();
+  opt.number = 0;
+  if (opt.is_string)
+    opt.string = val.string_value ();
+  else if (val.isnumeric () && val.numel () == 1)
+    opt.number = val.double_value ();
+  else
+    error ("mshm_gmsh: the value of %s must be a string or a scalar",
+           flag.c_str ());
+
+  // Option names such as Mesh.Algorithm are passed on unchanged.
+  if (flag.find ('.') != std::string::npos)
+    {
+      opt.name = flag;
+      return opt;
+    }
+
+  if (flag == "algo")
+    {
+      for (std::size_t k = 0;
+           k < sizeof (algorithms) / sizeof (algorithms[0]); ++k)
+        if (opt.string == algorithms[k].name)
+          {
+            opt.name = algorithms[k].dim == 2 ? "Mesh.Algorithm"
+                                              : "Mesh.Algorithm3D";
+            opt.is_string = false;
+            opt.number = algorithms[k].value;
+            return opt;
+          }
+      error_with_id ("msh:gmsh-option",
+                     "mshm_gmsh: unknown algorithm %s", opt.string.c_str ());
+    }
+
+  for (std::size_t k = 0; k < sizeof (cli_options) / sizeof (cli_options[0]);
+       ++k)
+    if (flag == cli_options[k][0])
+      {
+        opt.name = cli_options[k][1];
+        if (opt.is_string)
+          {
+            char *end;
+            opt.number = std::strtod (opt.string.c_str (), &end);
+            if (end == opt.string.c_str () || *end)
+              error ("mshm_gmsh: the value of %s must be a number",
+                     flag.c_str ());
+            opt.is_string = false;
+          }
+        return opt;
+      }
+
+  error_with_id ("msh:gmsh-option",
+                 "mshm_gmsh: option %s is not supported, use the name of "
+                 "the gmsh option instead, e.g. Mesh.MeshSizeFactor",
+                 flag.c_str ());
+}
+
+// Nodes and elements of the generated mesh, as returned by gmsh.
+struct gmsh_mesh
+{
+  std::vector<std::size_t> node_tags;
+  std::vector<double> coord;
+  std::vector<std::size_t> t, e, s;
+  std::vector<double> treg, elabel, slabel;
+  std::string log;
+};
+
+#if defined (HAVE_GMSH_H)
+
+// Elements of the given type in the entities of dimension dim, tagged
+// with the entity number or, if physical is true, with the number of
+// the physical group.  As in the msh2 files read by msh2m_gmsh and
+// msh3m_gmsh through the gmsh subprocess, if the model has physical
+// groups (and Mesh.SaveAll is not set) only the elements in the groups
+// of dimension dim are taken, once for each group they belong to.
+static void
+collect_elements (int dim, int type, int nn, bool physical, bool save_all,
+                  std::vector<std::size_t>& conn, std::vector<double>& tags)
+{
+  gmsh::vectorpair entities;
+  gmsh::model::getEntities (entities, dim);
+  std::vector<std::size_t> element_tags, node_tags;
+  std::vector<int> groups;
+  for (std::size_t g = 0; g < entities.size (); ++g)
+    {
+      const int entity = entities[g].second;
+      if (save_all)
+        groups.assign (1, entity);
+      else
+        {
+          gmsh::model::getPhysicalGroupsForEntity (dim, entity, groups);
+          if (! physical)
+            std::fill (groups.begin (), groups.end (), entity);
+        }
+      if (groups.empty ())
+        continue;
+
+      gmsh::model::mesh::getElementsByType (type, element_tags, node_tags,
+                                            entity);
+      for (std::size_t k = 0; k < element_tags.size (); ++k)
+        for (std::size_t c = 0; c < groups.size (); ++c)
+          {
+            conn.insert (conn.end (), node_tags.begin () + nn * k,
+                         node_tags.begin () + nn * (k + 1));
+            tags.push_back (groups[c]);
+          }
+    }
+}
+
+// Mesh the geometry in file; return an error message on failure.
+static std::string
+run_gmsh (const std::string& file, int dim,
+          const std::vector<gmsh_option>& options, bool physical,
+          gmsh_mesh& m)
+{
+  std::string err;
+  try
+    {
+      gmsh_session::start ();
+      gmsh::logger::start ();
+      gmsh::open (file);
+      for (std::size_t k = 0; k < options.size (); ++k)
+        if (options[k].is_string)
+          gmsh::option::setString (options[k].name, options[k].string);
+        else
+          gmsh::option::setNumber (options[k].name, options[k].number);
+      gmsh::model::mesh::generate (dim);
+
+      std::vector<double> param;
+      gmsh::model::mesh::getNodes (m.node_tags, m.coord, param, -1, -1,
+                                   false, false);
+      gmsh::vectorpair groups;
+      gmsh::model::getPhysicalGroups (groups);
+      double save_all = 0;
+      gmsh::option::getNumber ("Mesh.SaveAll", save_all);
+      const bool all = groups.empty () || save_all != 0;
+      collect_elements (dim, dim == 2 ? 2 : 4, dim + 1, physical, all,
+                        m.t, m.treg);
+      collect_elements (dim - 1, dim == 2 ? 1 : 2, dim, physical, all,
+                        m.e, m.elabel);
+      if (dim == 3)
+        collect_elements (1, 1, 2, physical, all, m.s, m.slabel);
+    }
+  catch (const std::exception& ex)
+    {
+      err = ex.what ();
+    }
+  catch (const std::string& msg)
+    {
+      err = msg;
+    }
+  catch (...)
+    {
+      err = "unknown error";
+    }
+
+  try
+    {
+      std::vector<std::string> log;
+      gmsh::logger::get (log);
+      gmsh::logger::stop ();
+      for (std::size_t k = 0; k < log.size (); ++k)
+        m.log += log[k] + "\n";
+    }
+  catch (...)
+    { }
+
+  return err;
+}
+
+#endif
+
+DEFUN_DLD (mshm_gmsh, args, nargout, "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{mesh}, @var{gmsh_out}]} = \
+mshm_gmsh (@var{geometry}, @var{dim}, @var{option}, @var{value}, \
+@dots{})\n\
+@deftypefnx {Function File} {@var{tf}} = mshm_gmsh (\"available\")\n\
+Construct an unstructured triangular (@var{dim} = 2) or tetrahedral \
+(@var{dim} = 3) mesh through the gmsh library, within the Octave \
+process.\n\
+\n\
+@var{geometry} is the name of the @code{*.geo} file to be meshed, with \
+or without the suffix.  The mesh is taken directly from gmsh, with no \
+temporary files, and the gmsh session is kept open between calls.\n\
+\n\
+@var{option} may be one of the command line options of gmsh \
+\"clscale\", \"clmin\", \"clmax\", \"clcurv\", \"rand\", \"smooth\", \
+\"optimize\", \"optimize_netgen\", \"nt\", \"v\" and \"algo\", or the \
+name of any gmsh option, such as \"Mesh.MeshSizeFactor\".  The \
+options \"labels\" and \"compact\" are not passed to gmsh, see \
+below.\n\
+\n\
+The returned value @var{mesh} is a PDE-tool like mesh structure, the \
+same as built by @code{msh2m_gmsh} and @code{msh3m_gmsh} through the \
+gmsh program.  If physical groups are defined, only the elements in \
+them are taken, as in the msh2 files written by gmsh.  The region \
+numbers in t and the side or face numbers in e are the numbers of the \
+geometrical entities, or those of the physical groups if \"labels\" \
+is \"physical\" (the default is \"entity\").  Nodes not belonging to \
+any element are removed.  In 2D the rows of e with the region numbers \
+on either side are filled in.  In 3D the field s contains the edges \
+in the physical curves.  If \"compact\" is true, @var{mesh} is \
+returned in the compact representation of @code{mshm_compact}.  \
+@var{gmsh_out} is the log of gmsh.\n\
+\n\
+@var{tf} is true if the package was built with the gmsh library \
+(gmsh.h and libgmsh required).\n\
+@seealso{msh2m_gmsh, msh3m_gmsh}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin == 1 && args(0).is_string ()
+      && args(0).string_value () == "available")
+    {
+#if defined (HAVE_GMSH_H)
+      retval(0) = true;
+#else
+      retval(0) = false;
+#endif
+      return retval;
+    }
+
+  if (nargin < 2 || nargin % 2 != 0)
+    print_usage ();
+  if (! args(0).is_string ())
+    error ("mshm_gmsh: GEOMETRY must be a string");
+  std::string file = args(0).string_value ();
+  if (file.size () < 4 || file.compare (file.size () - 4, 4, ".geo") != 0)
+    file += ".geo";
+  const int dim = args(1).int_value ();
+  if (dim != 2 && dim != 3)
+    error ("mshm_gmsh: DIM must be 2 or 3");
+
+  std::vector<gmsh_option> options;
+  bool physical = false, compact = false;
+  for (int nn = 2; nn < nargin; nn += 2)
+    {
+      if (! args(nn).is_string ())
+        error ("mshm_gmsh: only string value admitted for options.");
+      const std::string flag = args(nn).string_value ();
+      if (flag == "labels")
+        {
+          const std::string val = args(nn+1).is_string ()
+                                  ? args(nn+1).string_value () : "";
+          if (val != "entity" && val != "physical")
+            error ("mshm_gmsh: the value of labels must be \"entity\" or "
+                   "\"physical\"");
+          physical = val == "physical";
+        }
+      else if (flag == "compact")
+        {
+          if (args(nn+1).numel () != 1
+              || ! (args(nn+1).islogical () || args(nn+1).isnumeric ()))
+            error ("mshm_gmsh: the value of compact must be true or false");
+          compact = args(nn+1).bool_value ();
+        }
+      else
+        options.push_back (parse_option (flag, args(nn+1)));
+    }
+
+#if ! defined (HAVE_GMSH_H)
+  (void) physical;
+  (void) compact;
+  error_with_id ("msh:no-gmsh", "mshm_gmsh: the msh package was built "
+                 "without support for gmsh (gmsh.h required)");
+#else
+  gmsh_mesh gm;
+  const std::string err = run_gmsh (file, dim, options, physical, gm);
+  if (! err.empty ())
+    error ("mshm_gmsh: %s: %s", file.c_str (), err.c_str ());
+
+  const msh::index_t nt = gm.treg.size ();
+  if (nt == 0)
+    error ("mshm_gmsh: %s: no %s in the mesh", file.c_str (),
+           dim == 2 ? "triangles" : "tetrahedra");
+
+  // Number the nodes of the elements in the order of their tags.
+  std::size_t maxtag = 0;
+  for (std::size_t i = 0; i < gm.node_tags.size (); ++i)
+    maxtag = std::max (maxtag, gm.node_tags[i]);
+  std::vector<msh::index_t> node (maxtag + 1, -1), pos (maxtag + 1, -1);
+  for (std::size_t i = 0; i < gm.node_tags.size (); ++i)
+    pos[gm.node_tags[i]] = i;
+  for (std::size_t k = 0; k < gm.t.size (); ++k)
+    if (gm.t[k] > maxtag || pos[gm.t[k]] < 0)
+      error ("mshm_gmsh: element with unknown node %ld",
+             static_cast<long> (gm.t[k]));
+    else
+      node[gm.t[k]] = 0;
+  msh::index_t np = 0;
+  for (std::size_t tag = 0; tag <= maxtag; ++tag)
+    if (node[tag] == 0)
+      node[tag] = np++;
+
+  NDArray p (dim_vector (dim, np));
+  for (std::size_t tag = 0; tag <= maxtag; ++tag)
+    if (node[tag] >= 0)
+      for (int d = 0; d < dim; ++d)
+        p(d, node[tag]) = gm.coord[3 * pos[tag] + d];
+
+  NDArray t (dim_vector (dim + 2, nt));
+  for (msh::index_t j = 0; j < nt; ++j)
+    {
+      for (int k = 0; k <= dim; ++k)
+        t(k, j) = node[gm.t[(dim + 1) * j + k]] + 1;
+      t(dim + 1, j) = gm.treg[j];
+    }
+
+  // Sides or faces with nodes not belonging to any element are dropped.
+  // In 2D the others get the regions of the elements on either side.
+  msh::mesh_view<double> m;
+  m.dim = dim;
+  m.np = np;
+  m.ne = 0;
+  m.nt = nt;
+  m.p = p.data ();
+  m.e = 0;
+  m.t = t.data ();
+  m.erows = 0;
+  m.trows = dim + 2;
+  m.set_inline_tags ();
+  msh::csr_graph v2c;
+  if (dim == 2)
+    msh::build_v2c (m, v2c);
+
+  const msh::index_t erows = msh::standard_erows (dim);
+  std::vector<msh::index_t> keep;
+  for (std::size_t q = 0; q < gm.elabel.size (); ++q)
+    {
+      bool inside = true;
+      for (int a = 0; a < dim; ++a)
+        {
+          const std::size_t tag = gm.e[dim * q + a];
+          inside = inside && tag <= maxtag && node[tag] >= 0;
+        }
+      if (inside)
+        keep.push_back (q);
+    }
+
+  NDArray e (dim_vector (erows, keep.size ()), 0.0);
+  const int lrow = msh::label_row (dim);
+  for (std::size_t c = 0; c < keep.size (); ++c)
+    {
+      msh::index_t v[3];
+      for (int a = 0; a < dim; ++a)
+        {
+          v[a] = node[gm.e[dim * keep[c] + a]];
+          e(a, c) = v[a] + 1;
+        }
+      e(lrow, c) = gm.elabel[keep[c]];
+      if (dim == 3)
+        continue;
+
+      // The regions on either side, in the order of the elements given
+      // by msh2m_topological_properties (mesh, "boundary"): by the local
+      // number of the side (that of the opposite vertex), then by number.
+      const msh::index_t j1 = msh::element_with (m, v2c, v, 2);
+      const msh::index_t jj[2]
+        = {j1, j1 < 0 ? -1 : msh::element_with (m, v2c, v, 2, j1)};
+      std::pair<int, msh::index_t> side[2];
+      int ns = 0;
+      for (int q = 0; q < 2; ++q)
+        if (jj[q] >= 0)
+          {
+            int k = 0;
+            while (m.tv (k, jj[q]) == v[0] || m.tv (k, jj[q]) == v[1])
+              ++k;
+            side[ns++] = std::make_pair (k, jj[q]);
+          }
+      if (ns == 2 && side[1] < side[0])
+        std::swap (side[0], side[1]);
+      for (int q = 0; q < ns; ++q)
+        e(5 + q, c) = m.region (side[q].second);
+    }
+
+  octave_scalar_map mesh = compact ? msh::compact_mesh (p, e, t, "mshm_gmsh")
+                                   : msh::make_mesh (p, e, t);
+  if (dim == 3)
+    {
+      NDArray s (dim_vector (3, 0));
+      std::vector<msh::index_t> sk;
+      for (std::size_t q = 0; q < gm.slabel.size (); ++q)
+        if (gm.s[2 * q] <= maxtag && node[gm.s[2 * q]] >= 0
+            && gm.s[2 * q + 1] <= maxtag && node[gm.s[2 * q + 1]] >= 0)
+          sk.push_back (q);
+      s.resize (dim_vector (3, sk.size ()));
+      for (std::size_t c = 0; c < sk.size (); ++c)
+        {
+          s(0, c) = node[gm.s[2 * sk[c]]] + 1;
+          s(1, c) = node[gm.s[2 * sk[c] + 1]] + 1;
+          s(2, c) = gm.slabel[sk[c]];
+        }
+      mesh.setfield ("s", s);
+    }
+
+  retval(0) = mesh;
+  if (nargout > 1)
+    retval(1) = gm.log;
+#endif
+
+  return retval;
+}
+
+/*
+%!test
+%! assert (islogical (mshm_gmsh ("available")))
+
+%!test
+%! if (mshm_gmsh ("available"))
+%!   name = tempname ();
+%!   fid = fopen ([name ".geo"], "w");
+%!   fprintf (fid, "Point(1) = {0, 0, 0, .25};\nPoint(2) = {1, 0, 0, .25};\n");
+%!   fprintf (fid, "Point(3) = {1, 1, 0, .25};\nPoint(4) = {0, 1, 0, .25};\n");
+%!   fprintf (fid, "Line(1) = {1, 2};\nLine(2) = {2, 3};\n");
+%!   fprintf (fid, "Line(3) = {3, 4};\nLine(4) = {4, 1};\n");
+%!   fprintf (fid, "Line Loop(5) = {1, 2, 3, 4};\nPlane Surface(6) = {5};\n");
+%!   fprintf (fid, "Physical Line(10) = {1};\nPhysical Line(30) = {3};\n");
+%!   fprintf (fid, "Physical Surface(7) = {6};\n");
+%!   fclose (fid);
+%!   unwind_protect
+%!     mesh = mshm_gmsh (name, 2, "clscale", 1);
+%!     mesh2 = mshm_gmsh (name, 2, "Mesh.MeshSizeFactor", .5);
+%!     mesh3 = mshm_gmsh (name, 2, "labels", "physical");
+%!     mesh4 = mshm_gmsh (name, 2, "clscale", 1, "compact", true);
+%!   unwind_protect_cleanup
+%!     unlink ([name ".geo"]);
+%!   end_unwind_protect
+%!   assert (size (mesh.t, 1), 4)
+%!   assert (all (mesh.t(4,:) == 6))
+%!   assert (sort (unique (mesh.e(5,:))), [1 3])
+%!   assert (all (mesh.e(6,:) == 6))
+%!   area = msh2m_geometrical_properties (mesh, "area");
+%!   assert (sum (area), 1, 1e-12)
+%!   assert (columns (mesh2.t) > columns (mesh.t))
+%!   assert (unique (mesh.t(1:3,:))', 1:columns (mesh.p))
+%!   assert (mesh3.p, mesh.p)
+%!   assert (mesh3.t(1:3,:), mesh.t(1:3,:))
+%!   assert (all (mesh3.t(4,:) == 7))
+%!   assert (isa (mesh4.t, "int32"))
+%!   assert (mshm_expand (mesh4), mesh)
+%!   assert (sort (unique (mesh3.e(5,:))), [10 30])
+%! endif
+
+%!test
+%! [status, ~] = system ("gmsh --version");
+%! if (mshm_gmsh ("available") && status == 0)
+%!   name = tempname ();
+%!   fid = fopen ([name "_2.geo"], "w");
+%!   fprintf (fid, "Point(1) = {0, 0, 0, .3};\n");
+%!   fprintf (fid, "l[] = Extrude {1, 0, 0} {Point{1};};\n");
+%!   fprintf (fid, "s[] = Extrude {0, 1, 0} {Line{l[1]};};\n");
+%!   fprintf (fid, "Physical Surface(7) = {s[1]};\n");
+%!   fprintf (fid, "Physical Line(2) = {l[1], s[2]};\n");
+%!   fclose (fid);
+%!   fid = fopen ([name "_3.geo"], "w");
+%!   fprintf (fid, "Point(1) = {0, 0, 0, .4};\n");
+%!   fprintf (fid, "l[] = Extrude {1, 0, 0} {Point{1};};\n");
+%!   fprintf (fid, "s[] = Extrude {0, 1, 0} {Line{l[1]};};\n");
+%!   fprintf (fid, "v[] = Extrude {0, 0, 1} {Surface{s[1]};};\n");
+%!   fprintf (fid, "Physical Volume(7) = {v[1]};\n");
+%!   fprintf (fid, "Physical Surface(2) = {s[1], v[0]};\n");
+%!   fclose (fid);
+%!   unwind_protect
+%!     ## "format" is not supported by mshm_gmsh, so that the second
+%!     ## call of each pair runs the gmsh program.
+%!     mesh = msh2m_gmsh ([name "_2"], "v", 0);
+%!     mesh2 = msh2m_gmsh ([name "_2"], "v", 0, "format", "msh2");
+%!     vol = msh3m_gmsh ([name "_3"], "v", 0);
+%!     vol2 = msh3m_gmsh ([name "_3"], "v", 0, "format", "msh2");
+%!   unwind_protect_cleanup
+%!     unlink ([name "_2.geo"]);
+%!     unlink ([name "_3.geo"]);
+%!   end_unwind_protect
+%!   assert (mesh.p, mesh2.p, 1e-14)
+%!   assert (mesh.e, mesh2.e)
+%!   assert (mesh.t, mesh2.t)
+%!   assert (vol.p, vol2.p, 1e-14)
+%!   assert (vol.e, vol2.e)
+%!   assert (vol.t, vol2.t)
+%! endif
+
+%!error <option foo is not supported> mshm_gmsh ("geometry", 2, "foo", 1)
+*/
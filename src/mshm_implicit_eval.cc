@@ -0,0 +1,363 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+#include "msh_structured.h"
+
+// Element properties are computed on chunks of at most this many
+// elements, so that only a chunk at a time is expanded.
+static const msh::index_t chunk_size = 4096;
+
+struct grid_data
+{
+  int dim;
+  msh::grid_pattern pattern;
+  NDArray x, y, z, sides;
+  double region;
+};
+
+static NDArray
+grid_vector (const octave_scalar_map& s, const char *name)
+{
+  if (! s.isfield (name))
+    error ("mshm_implicit_eval: IMESH has no field %s", name);
+  octave_value v = s.getfield (name);
+  if (! (v.isnumeric () && v.is_vector () && v.numel () > 1))
+    error ("mshm_implicit_eval: IMESH.%s must be a numeric vector", name);
+  NDArray a = v.array_value ();
+  if (! std::is_sorted (a.data (), a.data () + a.numel ()))
+    error ("mshm_implicit_eval: IMESH.%s must be sorted", name);
+  return a;
+}
+
+static grid_data
+read_grid (const octave_value& v)
+{
+  if (! (v.isstruct () && v.numel () == 1))
+    error ("mshm_implicit_eval: IMESH must be built by mshm_implicit_mesh");
+  const octave_scalar_map s = v.scalar_map_value ();
+  if (! (s.isfield ("pattern") && s.getfield ("pattern").is_string ()
+         && s.isfield ("region") && s.isfield ("sides")))
+    error ("mshm_implicit_eval: IMESH must be built by mshm_implicit_mesh");
+
+  grid_data g;
+  const std::string pattern = s.getfield ("pattern").string_value ();
+  if (pattern == "right")
+    g.pattern = msh::grid_right;
+  else if (pattern == "left")
+    g.pattern = msh::grid_left;
+  else if (pattern == "kuhn")
+    g.pattern = msh::grid_kuhn;
+  else
+    error ("mshm_implicit_eval: unknown pattern %s", pattern.c_str ());
+  g.dim = g.pattern == msh::grid_kuhn ? 3 : 2;
+
+  g.x = grid_vector (s, "x");
+  g.y = grid_vector (s, "y");
+  if (g.dim == 3)
+    g.z = grid_vector (s, "z");
+  g.region = s.getfield ("region").double_value ();
+  g.sides = s.getfield ("sides").array_value ();
+  if (g.sides.numel () != 2 * g.dim)
+    error ("mshm_implicit_eval: IMESH.sides must have %d components",
+           2 * g.dim);
+  return g;
+}
+
+// 0-based numbers of the requested nodes, sides or elements; all of
+// them if no index vector is given.
+static std::vector<msh::index_t>
+selection (const octave_value& v, msh::index_t n, const std::string& prop)
+{
+  std::vector<msh::index_t> sel;
+  if (! v.is_defined ())
+    {
+      sel.resize (n);
+      for (msh::index_t i = 0; i < n; ++i)
+        sel[i] = i;
+      return sel;
+    }
+
+  NDArray a = v.array_value ();
+  sel.resize (a.numel ());
+  for (msh::index_t i = 0; i < a.numel (); ++i)
+    {
+      const double k = a(i);
+      if (! (k >= 1 && k <= n && k == std::floor (k)))
+        error ("mshm_implicit_eval: index %g out of bound for %s", k,
+               prop.c_str ());
+      sel[i] = static_cast<msh::index_t> (k) - 1;
+    }
+  return sel;
+}
+
+template <int P>
+static octave_value
+element_property (const msh::structured_grid<P>& g, const std::string& prop,
+                  const std::vector<msh::index_t>& sel)
+{
+  const int dim = msh::structured_grid<P>::dim, nv = dim + 1;
+  const msh::index_t n = sel.size ();
+  dim_vector dv;
+  msh::index_t stride;
+  if (prop == "bar")
+    {
+      dv = dim_vector (dim, n);
+      stride = dim;
+    }
+  else if (prop == "area")
+    {
+      dv = dim == 2 ? dim_vector (n, 1) : dim_vector (1, n);
+      stride = 1;
+    }
+  else if (prop == "wjacdet")
+    {
+      dv = dim_vector (nv, n);
+      stride = nv;
+    }
+  else if (prop == "shg")
+    {
+      dv = dim_vector (dim, nv, n);
+      stride = dim * nv;
+    }
+  else
+    {
+      dv = dim_vector (2, 3, n);
+      stride = 6;
+    }
+
+  NDArray b (dv);
+  double *bvec = b.fortran_vec ();
+#pragma omp parallel
+  {
+    std::vector<double> lp, lt;
+#pragma omp for schedule (dynamic, 1)
+    for (msh::index_t j0 = 0; j0 < n; j0 += chunk_size)
+      {
+        const msh::index_t nj = std::min (chunk_size, n - j0);
+        const msh::mesh_view<double> m
+          = msh::exploded_elements (g, sel.data () + j0, nj, lp, lt);
+        double *out = bvec + stride * j0;
+        if (prop == "bar")
+          msh::element_bar (m, 0, nj, out);
+        else if (prop == "area")
+          msh::element_area (m, 0, nj, out);
+        else if (prop == "wjacdet")
+          msh::element_wjacdet (m, 0, nj, out);
+        else if (prop == "shg")
+          msh::element_shg (m, 0, nj, out);
+        else
+          msh::element_midedge (m, 0, nj, out);
+      }
+  }
+  return b;
+}
+
+template <int P>
+static octave_value_list
+evaluate (const grid_data& gd, const octave_value_list& args)
+{
+  typedef msh::structured_grid<P> grid;
+  const int dim = grid::dim, nv = dim + 1;
+  const msh::index_t erows = msh::standard_erows (dim);
+  const grid g (gd.x.data (), gd.x.numel (), gd.y.data (), gd.y.numel (),
+                dim == 3 ? gd.z.data () : 0, dim == 3 ? gd.z.numel () : 0,
+                gd.region, gd.sides.data ());
+
+  octave_value_list retval;
+  int nout = 0;
+  for (int nn = 0; nn < args.length (); ++nn)
+    {
+      if (! args(nn).is_string ())
+        error ("mshm_implicit_eval: only string value admitted for "
+               "properties.");
+      const std::string prop = args(nn).string_value ();
+      octave_value idx;
+      if (nn + 1 < args.length () && ! args(nn+1).is_string ())
+        idx = args(++nn);
+
+      if (prop == "np")
+        retval(nout++) = static_cast<double> (g.num_points ());
+      else if (prop == "ne")
+        retval(nout++) = static_cast<double> (g.num_facets ());
+      else if (prop == "nt")
+        retval(nout++) = static_cast<double> (g.num_elements ());
+      else if (prop == "mesh")
+        {
+          NDArray p (dim_vector (dim, g.num_points ()));
+          NDArray e (dim_vector (erows, g.num_facets ()));
+          NDArray t (dim_vector (nv + 1, g.num_elements ()));
+          g.materialize (p.fortran_vec (), e.fortran_vec (),
+                         t.fortran_vec ());
+          retval(nout++) = msh::make_mesh (p, e, t);
+        }
+      else if (prop == "p")
+        {
+          const std::vector<msh::index_t> sel
+            = selection (idx, g.num_points (), prop);
+          NDArray p (dim_vector (dim, sel.size ()));
+          double *pvec = p.fortran_vec ();
+#pragma omp parallel for
+          for (msh::index_t q = 0; q < msh::index_t (sel.size ()); ++q)
+            g.point (sel[q], pvec + dim * q);
+          retval(nout++) = p;
+        }
+      else if (prop == "t")
+        {
+          const std::vector<msh::index_t> sel
+            = selection (idx, g.num_elements (), prop);
+          NDArray t (dim_vector (nv + 1, sel.size ()));
+          double *tvec = t.fortran_vec ();
+#pragma omp parallel for
+          for (msh::index_t q = 0; q < msh::index_t (sel.size ()); ++q)
+            {
+              msh::index_t v[nv];
+              g.element (sel[q], v);
+              for (int k = 0; k < nv; ++k)
+                tvec[k + (nv + 1) * q] = v[k] + 1;
+              tvec[nv + (nv + 1) * q] = g.element_region ();
+            }
+          retval(nout++) = t;
+        }
+      else if (prop == "e")
+        {
+          const std::vector<msh::index_t> sel
+            = selection (idx, g.num_facets (), prop);
+          NDArray e (dim_vector (erows, sel.size ()), 0.0);
+          double *evec = e.fortran_vec ();
+#pragma omp parallel for
+          for (msh::index_t q = 0; q < msh::index_t (sel.size ()); ++q)
+            {
+              msh::index_t v[dim];
+              double label;
+              g.facet (sel[q], v, label);
+              double *ef = evec + erows * q;
+              for (int k = 0; k < dim; ++k)
+                ef[k] = v[k] + 1;
+              ef[msh::label_row (dim)] = label;
+              ef[dim == 2 ? 6 : 8] = g.element_region ();
+            }
+          retval(nout++) = e;
+        }
+      else if (prop == "bar" || prop == "area" || prop == "wjacdet"
+               || prop == "shg" || (prop == "midedge" && dim == 2))
+        retval(nout++) = element_property (g, prop, selection
+                                           (idx, g.num_elements (), prop));
+      else
+        {
+          warning ("mshm_implicit_eval: unexpected value in property "
+                   "string. Empty vector passed as output.");
+          retval(nout++) = Matrix ();
+        }
+    }
+  return retval;
+}
+
+DEFUN_DLD (mshm_implicit_eval, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{varargout}]} = \
+mshm_implicit_eval (@var{imesh}, @var{string1}, [@var{idx1}], \
+@var{string2}, [@var{idx2}], @dots{})\n\
+Compute the quantities identified by the input strings for the \
+structured mesh described by @var{imesh}, as built by \
+@code{mshm_implicit_mesh}, without building the whole mesh.\n\
+\n\
+Each string may be followed by a vector of indices selecting the \
+nodes, sides (in 2D) or faces (in 3D), or elements for which the \
+quantity is computed; by default it is computed for all of them.  \
+The numbering is the one of the mesh built by \
+@code{msh2m_structured_mesh} or @code{msh3m_structured_mesh}.  Valid \
+strings are:\n\
+@itemize @bullet\n\
+@item @code{\"np\"}, @code{\"ne\"}, @code{\"nt\"}: the number of \
+nodes, of boundary sides or faces and of elements;\n\
+@item @code{\"p\"}, @code{\"e\"}, @code{\"t\"}: the corresponding \
+columns of the fields p, e and t of the mesh;\n\
+@item @code{\"bar\"}, @code{\"area\"}, @code{\"wjacdet\"}, \
+@code{\"shg\"} and, in 2D, @code{\"midedge\"}: the geometrical \
+properties computed by @code{msh2m_geometrical_properties} and \
+@code{msh3m_geometrical_properties}, for the selected elements;\n\
+@item @code{\"mesh\"}: the whole mesh, as a PDE-tool like structure.\n\
+@end itemize\n\
+\n\
+Coordinates and connectivity are computed from the grid vectors and \
+the position of each item in the grid, and the element properties are \
+computed on small batches of elements, so the memory used only \
+depends on the size of the output.\n\
+The output will contain the quantities requested in the input in the \
+same order specified in the function call.\n\
+@seealso{mshm_implicit_mesh, msh2m_geometrical_properties, \
+msh3m_geometrical_properties}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin < 2)
+    print_usage ();
+
+  const grid_data gd = read_grid (args(0));
+  const octave_value_list props = args.slice (1, nargin - 1);
+  switch (gd.pattern)
+    {
+    case msh::grid_right:
+      return evaluate<msh::grid_right> (gd, props);
+    case msh::grid_left:
+      return evaluate<msh::grid_left> (gd, props);
+    default:
+      return evaluate<msh::grid_kuhn> (gd, props);
+    }
+}
+
+/*
+%!test
+%! x = [0 .3 1]; y = [0 .5 .7 2];
+%! for orient = {"right", "left"}
+%!   mesh = msh2m_structured_mesh (x, y, 2, [4 3 2 1], orient{1});
+%!   imesh = mshm_implicit_mesh (x, y, 2, [4 3 2 1], orient{1});
+%!   assert (mshm_implicit_eval (imesh, "mesh"), mesh)
+%!   [np, p, t, e] = mshm_implicit_eval (imesh, "np", "p", [9 2], "t", 5, "e");
+%!   assert (np, columns (mesh.p))
+%!   assert (p, mesh.p(:,[9 2]))
+%!   assert (t, mesh.t(:,5))
+%!   assert (e, mesh.e)
+%!   [area, shg] = mshm_implicit_eval (imesh, "area", "shg", 1:3);
+%!   [area0, shg0] = msh2m_geometrical_properties (mesh, "area", "shg");
+%!   assert (area, area0, 1e-14)
+%!   assert (shg, shg0(:,:,1:3), 1e-14)
+%! endfor
+
+%!test
+%! x = [0 .3 1]; y = [0 .5 .7 2]; z = [-1 0 .5];
+%! mesh = msh3m_structured_mesh (x, y, z, 1, 1:6);
+%! imesh = mshm_implicit_mesh (x, y, z, 1, 1:6);
+%! assert (mshm_implicit_eval (imesh, "mesh"), mesh)
+%! [ne, e, wjacdet] = mshm_implicit_eval (imesh, "ne", "e", [3 20], "wjacdet");
+%! assert (ne, columns (mesh.e))
+%! assert (e, mesh.e(:,[3 20]))
+%! assert (wjacdet, msh3m_geometrical_properties (mesh, "wjacdet"), 1e-14)
+
+%!error <out of bound> mshm_implicit_eval (mshm_implicit_mesh (0:2, 0:2, 1, 1:4), "p", 10)
+*/
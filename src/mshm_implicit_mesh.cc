@@ -0,0 +1,118 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <string>
+
+static RowVector
+sorted_vector (const octave_value& v, const char *name)
+{
+  if (! (v.isnumeric () && v.is_vector () && v.numel () > 1))
+    error ("mshm_implicit_mesh: %s must be valid numeric vectors.", name);
+  NDArray a = v.array_value ();
+  RowVector x (a.numel ());
+  std::copy (a.data (), a.data () + a.numel (), x.fortran_vec ());
+  std::sort (x.fortran_vec (), x.fortran_vec () + x.numel ());
+  return x;
+}
+
+DEFUN_DLD (mshm_implicit_mesh, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{imesh}]} = \
+mshm_implicit_mesh (@var{x}, @var{y}, @var{region}, @var{sides})\n\
+@deftypefnx {Function File} {[@var{imesh}]} = \
+mshm_implicit_mesh (@var{x}, @var{y}, @var{region}, @var{sides}, \
+@var{string})\n\
+@deftypefnx {Function File} {[@var{imesh}]} = \
+mshm_implicit_mesh (@var{x}, @var{y}, @var{z}, @var{region}, @var{sides})\n\
+Describe the mesh built by @code{msh2m_structured_mesh} or \
+@code{msh3m_structured_mesh} with the same arguments without building \
+it.\n\
+\n\
+@var{imesh} is a structure with the sorted grid vectors @var{x}, \
+@var{y} (and @var{z}), @var{region}, @var{sides} and the field \
+@code{pattern}, which is @code{\"right\"} or @code{\"left\"} in 2D, as \
+given by @var{string}, and @code{\"kuhn\"} in 3D.  Its size does not \
+depend on the number of elements.  The coordinates, connectivity, \
+boundary sides or faces and geometrical properties of any part of the \
+mesh are computed on demand by @code{mshm_implicit_eval}, with the \
+same numbering as the explicit mesh, which is only built when \
+@code{mshm_implicit_eval} is asked for the whole mesh.\n\
+\n\
+The @code{\"random\"} orientation of @code{msh2m_structured_mesh} is \
+not supported.\n\
+@seealso{mshm_implicit_eval, msh2m_structured_mesh, \
+msh3m_structured_mesh}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin < 4 || nargin > 5)
+    print_usage ();
+
+  const bool is2d = nargin == 4 || args(4).is_string ();
+  const int dim = is2d ? 2 : 3;
+  octave_scalar_map imesh;
+  imesh.setfield ("x", sorted_vector (args(0), is2d ? "X and Y" : "X, Y, Z"));
+  imesh.setfield ("y", sorted_vector (args(1), is2d ? "X and Y" : "X, Y, Z"));
+  if (! is2d)
+    imesh.setfield ("z", sorted_vector (args(2), "X, Y, Z"));
+
+  const octave_value region = args(dim);
+  const octave_value sides = args(dim + 1);
+  if (! (region.isnumeric () && region.numel () == 1))
+    error ("mshm_implicit_mesh: REGION must be a valid scalar.");
+  if (! (sides.isnumeric () && sides.is_vector ()
+         && sides.numel () == 2 * dim))
+    error ("mshm_implicit_mesh: SIDES must be a %d components vector.",
+           2 * dim);
+  imesh.setfield ("region", region.double_value ());
+  imesh.setfield ("sides", RowVector (sides.array_value ()));
+
+  std::string pattern = is2d ? "right" : "kuhn";
+  if (is2d && nargin == 5)
+    {
+      pattern = args(4).string_value ();
+      if (pattern != "right" && pattern != "left")
+        error ("mshm_implicit_mesh: the orientation must be \"right\" or "
+               "\"left\"");
+    }
+  imesh.setfield ("pattern", pattern);
+  retval(0) = imesh;
+
+  return retval;
+}
+
+/*
+%!test
+%! imesh = mshm_implicit_mesh ([1 0 .5], 0:2, 1, 1:4, "left");
+%! assert (imesh.x, [0 .5 1])
+%! assert (imesh.pattern, "left")
+%! assert (! isfield (imesh, "p"))
+
+%!test
+%! imesh = mshm_implicit_mesh (0:2, 0:2, 0:2, 3, 1:6);
+%! assert (imesh.pattern, "kuhn")
+%! assert (imesh.region, 3)
+
+%!error <orientation> mshm_implicit_mesh (0:2, 0:2, 1, 1:4, "random")
+%!error <SIDES> mshm_implicit_mesh (0:2, 0:2, 0:2, 1, 1:4)
+*/
@@ -0,0 +1,276 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <octave/parse.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+#include "msh_octree.h"
+
+// The desired size in a cell: the constant or the value at its center
+// of the size function, and the size of any refinement box overlapping
+// the cell if smaller.
+class size_function
+{
+public:
+
+  size_function (int dim, const octave_value& h, const NDArray& boxes)
+    : m_dim (dim), m_h (HUGE_VAL), m_fcn (), m_boxes (boxes)
+  {
+    if (h.is_function_handle ())
+      m_fcn = h;
+    else
+      m_h = h.double_value ();
+  }
+
+  void
+  operator () (const double *c, const double *half, msh::index_t n,
+               double *h)
+  {
+    if (m_fcn.is_defined ())
+      {
+        Matrix x (m_dim, n);
+        std::copy (c, c + m_dim * n, x.fortran_vec ());
+        octave_value_list r = octave::feval (m_fcn, octave_value (x), 1);
+        if (r.length () < 1 || ! r(0).isnumeric () || r(0).numel () != n)
+          error ("mshm_octree_mesh: the size function must return one "
+                 "value for each column of its input");
+        const NDArray hv = r(0).array_value ();
+        std::copy (hv.data (), hv.data () + n, h);
+      }
+    else
+      std::fill (h, h + n, m_h);
+
+    const msh::index_t nb = m_boxes.rows ();
+    const double *bvec = m_boxes.data ();
+#pragma omp parallel for
+    for (msh::index_t q = 0; q < n; ++q)
+      for (msh::index_t b = 0; b < nb; ++b)
+        {
+          bool overlap = true;
+          for (int d = 0; d < m_dim; ++d)
+            {
+              const double lo = bvec[b + nb * 2 * d];
+              const double hi = bvec[b + nb * (2 * d + 1)];
+              const double x = c[m_dim * q + d];
+              overlap = overlap && x + half[d] > lo && x - half[d] < hi;
+            }
+          if (overlap)
+            h[q] = std::min (h[q], bvec[b + nb * 2 * m_dim]);
+        }
+  }
+
+private:
+
+  int m_dim;
+  double m_h;
+  octave_value m_fcn;
+  NDArray m_boxes;
+};
+
+DEFUN_DLD (mshm_octree_mesh, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{mesh}]} = \
+mshm_octree_mesh (@var{box}, @var{h})\n\
+@deftypefnx {Function File} {[@var{mesh}]} = \
+mshm_octree_mesh (@var{box}, @var{h}, @var{property}, @var{value}, \
+@dots{})\n\
+Construct a graded triangular (tetrahedral) mesh of a rectangle \
+(parallelepiped) by refining a quadtree (octree).\n\
+\n\
+@var{box} is @code{[xmin xmax ymin ymax]} in 2D and \
+@code{[xmin xmax ymin ymax zmin zmax]} in 3D.  The box is first covered \
+by a grid of nearly square (cubic) cells, which are split in four \
+(eight) until their width is not larger than @var{h}.  @var{h} is \
+either a scalar or a function handle which is called with a dim x n \
+matrix of cell centers and must return the n desired sizes at those \
+points.\n\
+\n\
+The tree is then refined so that leaves sharing a vertex differ by at \
+most one level, and each leaf is split into triangles (tetrahedra) \
+conforming with those of its neighbours: leaves with no finer \
+neighbours are split in two triangles in 2D, the others are split \
+with a vertex at their center.  All steps are carried out in \
+parallel over the cells of each level.\n\
+\n\
+The returned value @var{mesh} is a PDE-tool like mesh structure with \
+the layout of the meshes built by @code{msh2m_structured_mesh} and \
+@code{msh3m_structured_mesh}, with all the elements in the same region \
+and the boundary sides (faces) numbered as in those functions.\n\
+\n\
+The following properties can be set:\n\
+@table @asis\n\
+@item \"boxes\"\n\
+matrix whose rows are @code{[xmin xmax ymin ymax hb]} \
+(@code{[xmin xmax ymin ymax zmin zmax hb]} in 3D): the cells \
+overlapping a box are refined until their width is not larger than \
+hb;\n\
+@item \"compact\"\n\
+if true, return @var{mesh} in the compact representation of \
+@code{mshm_compact} (default false);\n\
+@item \"maxlevel\"\n\
+maximum number of refinements of the initial cells, from 0 to 20 \
+(default 12); it is further reduced to at most about 20 minus the base \
+2 logarithm of the number of initial cells in each direction;\n\
+@item \"region\"\n\
+region number of the elements (default 1);\n\
+@item \"sides\"\n\
+numbers of the sides (faces) of the box (default 1:4, or 1:6 in 3D).\n\
+@end table\n\
+@seealso{msh2m_structured_mesh, msh3m_structured_mesh, mshm_remesh}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin % 2 != 0)
+    print_usage ();
+
+  if (! (args(0).isnumeric () && (args(0).numel () == 4
+                                  || args(0).numel () == 6)))
+    error ("mshm_octree_mesh: BOX must have 4 or 6 entries");
+  const NDArray box = args(0).array_value ();
+  const int dim = box.numel () / 2;
+  double lo[3], hi[3];
+  for (int d = 0; d < dim; ++d)
+    {
+      lo[d] = box(2 * d);
+      hi[d] = box(2 * d + 1);
+      if (! (hi[d] > lo[d]))
+        error ("mshm_octree_mesh: BOX must have positive widths");
+    }
+
+  const octave_value h = args(1);
+  if (! (h.is_function_handle ()
+         || (h.isnumeric () && h.numel () == 1 && h.double_value () > 0)))
+    error ("mshm_octree_mesh: H must be a positive scalar or a function "
+           "handle");
+
+  NDArray boxes (dim_vector (0, 2 * dim + 1));
+  int maxlevel = 12;
+  double region = 1;
+  bool compact = false;
+  std::vector<double> sides (2 * dim);
+  for (int s = 0; s < 2 * dim; ++s)
+    sides[s] = s + 1;
+  for (int nn = 2; nn < nargin; nn += 2)
+    {
+      if (! args(nn).is_string ())
+        error ("mshm_octree_mesh: only string value admitted for "
+               "properties.");
+      std::string prop = args(nn).string_value ();
+      const octave_value& val = args(nn+1);
+      if (prop == "compact" && val.numel () == 1
+          && (val.islogical () || val.isnumeric ()))
+        {
+          compact = val.bool_value ();
+          continue;
+        }
+      if (! val.isnumeric ())
+        error ("mshm_octree_mesh: the value of %s must be numeric",
+               prop.c_str ());
+      if (prop == "boxes" && val.columns () == 2 * dim + 1)
+        boxes = val.array_value ();
+      else if (prop == "maxlevel" && val.numel () == 1
+               && val.double_value () >= 0
+               && val.double_value () < msh::octree::bits)
+        maxlevel = static_cast<int> (val.double_value ());
+      else if (prop == "region" && val.numel () == 1)
+        region = val.double_value ();
+      else if (prop == "sides" && val.numel () == 2 * dim)
+        {
+          const NDArray sv = val.array_value ();
+          std::copy (sv.data (), sv.data () + 2 * dim, sides.begin ());
+        }
+      else
+        error ("mshm_octree_mesh: invalid property or value: %s",
+               prop.c_str ());
+    }
+
+  msh::octree tree (dim, lo, hi, maxlevel);
+  if (! tree.fits ())
+    error ("mshm_octree_mesh: BOX is too elongated, the ratio of its "
+           "longest to its shortest side must be below %d",
+           1 << (msh::octree::bits - 1));
+  size_function size (dim, h, boxes);
+  tree.refine (size);
+  tree.balance ();
+
+  std::vector<double> p, e, t;
+  tree.mesh (region, &sides[0], p, e, t);
+
+  const msh::index_t erows = msh::standard_erows (dim);
+  NDArray pa (dim_vector (dim, p.size () / dim));
+  NDArray ea (dim_vector (erows, e.size () / erows));
+  NDArray ta (dim_vector (dim + 2, t.size () / (dim + 2)));
+  std::copy (p.begin (), p.end (), pa.fortran_vec ());
+  std::copy (e.begin (), e.end (), ea.fortran_vec ());
+  std::copy (t.begin (), t.end (), ta.fortran_vec ());
+  retval(0) = compact ? msh::compact_mesh (pa, ea, ta, "mshm_octree_mesh")
+                     : msh::make_mesh (pa, ea, ta);
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = mshm_octree_mesh ([0 1 0 1], .5);
+%! assert (size (mesh.p), [2 9])
+%! assert (size (mesh.t), [4 8])
+%! assert (sort (mesh.e(5,:)), [1 1 2 2 3 3 4 4])
+%! area = msh2m_geometrical_properties (mesh, "area");
+%! assert (sum (area), 1, 1e-14)
+
+%!test
+%! mesh = mshm_octree_mesh ([0 2 0 1], @(x) .01 + .5 * sqrt (sum (x.^2, 1)));
+%! area = msh2m_geometrical_properties (mesh, "area");
+%! assert (sum (area), 2, 1e-12)
+%! assert (mshm_check (mesh).valid)
+%! h = sqrt (2 * area);
+%! bar = msh2m_geometrical_properties (mesh, "bar");
+%! assert (max (h(sqrt (sum (bar.^2)) < .1)) < max (h(sqrt (sum (bar.^2)) > 1)))
+%! for s = 1:4
+%!   jj = mesh.e(5,:) == s;
+%!   len = sum (sqrt (sum ((mesh.p(:,mesh.e(1,jj)) - mesh.p(:,mesh.e(2,jj))).^2)));
+%!   assert (len, 1 + (mod (s, 2) == 1), 1e-12)
+%! endfor
+
+%!test
+%! mesh = mshm_octree_mesh ([0 1 0 1 0 1], 1, "boxes", [0 .2 0 .2 0 .2 .05], "region", 3, "sides", 11:16);
+%! vol = msh3m_geometrical_properties (mesh, "area");
+%! assert (sum (vol), 1, 1e-12)
+%! assert (all (vol > 0))
+%! assert (all (mesh.t(5,:) == 3))
+%! assert (sort (unique (mesh.e(10,:))), 11:16)
+%! assert (mshm_check (mesh).valid)
+
+%!test
+%! mesh = mshm_octree_mesh ([0 1 0 1], .25, "compact", true);
+%! assert (isa (mesh.t, "int32"))
+%! assert (mshm_expand (mesh), mshm_octree_mesh ([0 1 0 1], .25))
+
+%!error <BOX> mshm_octree_mesh ([0 1 0], .1)
+%!error <invalid property> mshm_octree_mesh ([0 1 0 1], .1, "maxlevel", 70)
+%!error <too elongated> mshm_octree_mesh ([0 3e6 0 1], 1e6, "maxlevel", 0)
+*/
@@ -0,0 +1,280 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+struct plot_options
+{
+  bool boundary_only;
+  double budget;
+  bool all_labels;
+  std::vector<double> labels;
+};
+
+// Vertices (np2 x dim), faces (nf x nvf) and labels (nf x 1) for
+// patch, from the selected facets, keeping only the nodes they use.
+template <typename T>
+static octave_value_list
+patch_data (const msh::mesh_view<T>& m, int nvf,
+            const std::vector<msh::index_t>& verts,
+            const std::vector<double>& label)
+{
+  const msh::index_t nf = label.size ();
+  std::vector<msh::index_t> node (m.np, 0);
+#pragma omp parallel for
+  for (msh::index_t q = 0; q < nvf * nf; ++q)
+    {
+#pragma omp atomic write
+      node[verts[q]] = 1;
+    }
+  msh::index_t np2 = 0;
+  for (msh::index_t i = 0; i < m.np; ++i)
+    node[i] = node[i] ? np2++ : -1;
+
+  Matrix v (np2, m.dim), f (nf, nvf);
+  ColumnVector c (nf);
+#pragma omp parallel for
+  for (msh::index_t i = 0; i < m.np; ++i)
+    if (node[i] >= 0)
+      for (int d = 0; d < m.dim; ++d)
+        v(node[i], d) = m.point (i)[d];
+#pragma omp parallel for
+  for (msh::index_t q = 0; q < nf; ++q)
+    {
+      for (int a = 0; a < nvf; ++a)
+        f(q, a) = node[verts[nvf * q + a]] + 1;
+      c(q) = label[q];
+    }
+
+  octave_value_list retval;
+  retval(0) = v;
+  retval(1) = f;
+  retval(2) = c;
+  return retval;
+}
+
+// Edges of a 2D mesh: those on the boundary, on the interfaces between
+// regions or in e are always kept, the others unless boundary_only is
+// set, thinned out to the budget.
+template <typename T>
+static octave_value_list
+edge_data (const msh::mesh_view<T>& m, const plot_options& opt)
+{
+  msh::facet_table ft;
+  msh::build_facet_table (m, ft);
+  const msh::index_t nf = ft.num_facets ();
+
+  std::vector<unsigned char> feature (nf, 0), keep;
+  std::vector<double> flabel (nf, 0);
+#pragma omp parallel for
+  for (msh::index_t f = 0; f < nf; ++f)
+    feature[f] = ft.count[f] != 2
+      || m.region (ft.cell[2 * f]) != m.region (ft.cell[2 * f + 1]);
+  const int lrow = msh::label_row (m.dim);
+  for (msh::index_t q = 0; q < m.ne; ++q)
+    {
+      const msh::index_t v[2] = {m.ev (0, q), m.ev (1, q)};
+      const msh::index_t f = ft.find (v);
+      if (f >= 0)
+        {
+          feature[f] = 1;
+          flabel[f] = m.elabel (lrow, q);
+        }
+    }
+
+  std::vector<unsigned char> interior (nf);
+  msh::index_t ninterior = 0;
+  for (msh::index_t f = 0; f < nf; ++f)
+    ninterior += interior[f] = ! feature[f] && ! opt.boundary_only;
+  if (ninterior > opt.budget)
+    {
+      std::vector<double> mid (2 * nf);
+#pragma omp parallel for
+      for (msh::index_t f = 0; f < nf; ++f)
+        for (int d = 0; d < 2; ++d)
+          mid[2 * f + d] = (m.point (ft.verts[2 * f])[d]
+                            + m.point (ft.verts[2 * f + 1])[d]) / 2;
+      msh::thin_on_grid (&mid[0], 2, nf, interior, opt.budget, keep);
+    }
+  else
+    keep.swap (interior);
+
+  std::vector<msh::index_t> verts;
+  std::vector<double> label;
+  for (msh::index_t f = 0; f < nf; ++f)
+    if (feature[f] || keep[f])
+      {
+        verts.push_back (ft.verts[2 * f]);
+        verts.push_back (ft.verts[2 * f + 1]);
+        label.push_back (flabel[f]);
+      }
+  return patch_data (m, 2, verts, label);
+}
+
+// Faces in e of a 3D mesh with the selected labels.
+template <typename T>
+static octave_value_list
+face_data (const msh::mesh_view<T>& m, const plot_options& opt)
+{
+  const int lrow = msh::label_row (m.dim);
+  std::vector<unsigned char> sel (m.ne);
+#pragma omp parallel for
+  for (msh::index_t q = 0; q < m.ne; ++q)
+    sel[q] = opt.all_labels
+      || std::binary_search (opt.labels.begin (), opt.labels.end (),
+                             m.elabel (lrow, q));
+
+  std::vector<msh::index_t> verts;
+  std::vector<double> label;
+  for (msh::index_t q = 0; q < m.ne; ++q)
+    if (sel[q])
+      {
+        for (int a = 0; a < 3; ++a)
+          verts.push_back (m.ev (a, q));
+        label.push_back (m.elabel (lrow, q));
+      }
+  return patch_data (m, 3, verts, label);
+}
+
+template <typename T>
+static octave_value_list
+plot_data (const msh::mesh_view<T>& m, const plot_options& opt)
+{
+  return m.dim == 2 ? edge_data (m, opt) : face_data (m, opt);
+}
+
+DEFUN_DLD (mshm_plot_data, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{vertices}, @var{faces}, \
+@var{labels}]} = mshm_plot_data (@var{mesh})\n\
+@deftypefnx {Function File} {[@var{vertices}, @var{faces}, \
+@var{labels}]} = mshm_plot_data (@var{mesh}, @var{property}, \
+@var{value}, @dots{})\n\
+Prepare the data for drawing @var{mesh} as a single patch object.\n\
+\n\
+For a 2D mesh each row of @var{faces} contains the two nodes of an \
+edge, each edge of the mesh being listed once.  For a 3D mesh each row \
+of @var{faces} contains the three nodes of a face in e.  @var{vertices} \
+contains the coordinates of the nodes used by @var{faces}, one per \
+row, and @var{labels} the side or face number of each edge or face \
+(0 for edges not in e), so that the mesh can be drawn with\n\
+\n\
+@example\n\
+patch (\"Faces\", @var{faces}, \"Vertices\", @var{vertices}, @dots{})\n\
+@end example\n\
+\n\
+The following properties can be set:\n\
+@table @asis\n\
+@item \"edges\"\n\
+\"all\" (default) or \"boundary\" to list only the edges on the \
+boundary, on the interfaces between regions or in e (2D only);\n\
+@item \"budget\"\n\
+approximate number of the other edges to list (2D only); if there \
+are more, those with the lowest numbers in each cell of a grid with \
+about this number of cells are kept, so that the mesh can be inspected \
+interactively with a resolution matching the budget.  Somewhat more \
+edges than the budget may be kept, at most 4 times as many for very \
+elongated meshes (default Inf);\n\
+@item \"labels\"\n\
+numbers of the faces to list (3D only, default all).\n\
+@end table\n\
+@seealso{msh2p_mesh, msh3p_mesh}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin % 2 != 1)
+    print_usage ();
+
+  msh::octave_mesh mesh (args(0), "mshm_plot_data");
+  const int dim = mesh.dim ();
+
+  plot_options opt;
+  opt.boundary_only = false;
+  opt.budget = HUGE_VAL;
+  opt.all_labels = true;
+  for (int nn = 1; nn < nargin; nn += 2)
+    {
+      if (! args(nn).is_string ())
+        error ("mshm_plot_data: only string value admitted for "
+               "properties.");
+      std::string prop = args(nn).string_value ();
+      const octave_value& val = args(nn+1);
+      if (prop == "edges" && dim == 2 && val.is_string ()
+          && (val.string_value () == "all"
+              || val.string_value () == "boundary"))
+        opt.boundary_only = val.string_value () == "boundary";
+      else if (prop == "budget" && dim == 2 && val.isnumeric ()
+               && val.numel () == 1 && val.double_value () >= 0)
+        opt.budget = val.double_value ();
+      else if (prop == "labels" && dim == 3 && val.isnumeric ())
+        {
+          const NDArray l = val.array_value ();
+          opt.labels.assign (l.data (), l.data () + l.numel ());
+          std::sort (opt.labels.begin (), opt.labels.end ());
+          opt.all_labels = false;
+        }
+      else
+        error ("mshm_plot_data: invalid property or value: %s",
+               prop.c_str ());
+    }
+
+  return mesh.compact () ? plot_data (mesh.cview (), opt)
+                         : plot_data (mesh.view (), opt);
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4);
+%! [v, f, l] = mshm_plot_data (mesh);
+%! assert (v, mesh.p')
+%! assert (rows (f), 16)
+%! assert (rows (unique (sort (f, 2), "rows")), 16)
+%! assert (sort (l(l > 0))', [1 1 2 2 3 3 4 4])
+%! [v, f] = mshm_plot_data (mshm_compact (mesh), "edges", "boundary");
+%! assert (rows (f), 8)
+%! assert (rows (v), 8)
+
+%!test
+%! x = linspace (0, 1, 101);
+%! mesh1 = msh2m_structured_mesh (x, x, 1, 1:4);
+%! mesh2 = msh2m_structured_mesh (x + 1, x, 2, 5:8);
+%! mesh = msh2m_join_structured_mesh (mesh1, mesh2, 2, 8);
+%! [v, f, l] = mshm_plot_data (mesh, "budget", 1000);
+%! nfeature = 6 * 100 + 100;
+%! assert (rows (f) > nfeature && rows (f) < nfeature + 1200)
+%! [v, f] = mshm_plot_data (mesh, "edges", "boundary");
+%! assert (rows (f), nfeature)
+
+%!test
+%! mesh = msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6);
+%! [v, f, l] = mshm_plot_data (mesh, "labels", [1 2]);
+%! assert (rows (f), 16)
+%! assert (unique (l)', [1 2])
+%! assert (rows (v), 18)
+
+%!error <invalid property> mshm_plot_data (msh2m_structured_mesh (0:1, 0:1, 1, 1:4), "labels", 1)
+*/
@@ -0,0 +1,221 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+
+// Check that pp is a scalar piecewise polynomial as built by mkpp and
+// keep its breaks and coefficients alive in the given arrays.
+static void
+get_pp (const octave_value& val, NDArray& breaks, NDArray& coefs,
+        msh::index_t& pieces, int& order)
+{
+  if (! (val.isstruct () && val.numel () == 1))
+    error ("mshm_promote_p2: XPP and YPP must be piecewise polynomials");
+  octave_scalar_map pp = val.scalar_map_value ();
+  if (! (pp.isfield ("breaks") && pp.isfield ("coefs")
+         && pp.isfield ("pieces") && pp.isfield ("order")
+         && pp.isfield ("dim") && pp.contents ("dim").numel () == 1
+         && pp.contents ("dim").double_value () == 1))
+    error ("mshm_promote_p2: XPP and YPP must be scalar piecewise "
+           "polynomials");
+  breaks = pp.contents ("breaks").array_value ();
+  coefs = pp.contents ("coefs").array_value ();
+  pieces = pp.contents ("pieces").idx_type_value ();
+  order = pp.contents ("order").int_value ();
+  if (breaks.numel () != pieces + 1 || coefs.rows () != pieces
+      || coefs.cols () != order)
+    error ("mshm_promote_p2: invalid piecewise polynomial");
+}
+
+// Fill p2, e2 and t2 for the mesh m, whose connectivity is stored as
+// T in arrays of type A.
+template <typename T, typename A>
+static void
+promote (const msh::mesh_view<T>& m, const NDArray& labels,
+         const msh::pp_curve *curve, msh::index_t e2rows, NDArray& p2, A& e2,
+         A& t2)
+{
+  msh::edge_table et;
+  msh::build_edge_table (m, et);
+
+  const int nle = msh::num_local_edges (m.dim);
+  p2 = NDArray (dim_vector (m.dim, m.np + et.num_edges ()));
+  e2 = A (dim_vector (m.ne > 0 ? e2rows : 0, m.ne));
+  t2 = A (dim_vector (m.trows + nle, m.nt));
+  double *p2vec = p2.fortran_vec ();
+  T *e2vec = msh::writable_data (e2);
+
+  msh::promote_p2 (m, et, p2vec, e2vec, msh::writable_data (t2));
+
+  if (curve && m.ne > 0)
+    msh::project_p2_edges (m, e2vec, e2.rows (), labels.data (),
+                           labels.numel (), *curve, p2vec);
+}
+
+DEFUN_DLD (mshm_promote_p2, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{mesh2}]} = \
+mshm_promote_p2 (@var{mesh})\n\
+@deftypefnx {Function File} {[@var{mesh2}]} = \
+mshm_promote_p2 (@var{mesh}, @var{sidelist}, @var{xpp}, @var{ypp})\n\
+Promote a linear triangular or tetrahedral mesh to a quadratic one.\n\
+\n\
+A node is added at the midpoint of every edge of @var{mesh}; each \
+mid-edge node is created once and shared by all the elements around \
+the edge.  The new nodes are appended to the columns of @var{mesh}.p, \
+the existing nodes keep their numbers.\n\
+\n\
+The field @var{mesh2}.t has the rows of @var{mesh}.t followed by the \
+numbers of the mid-edge nodes of each element:\n\
+@itemize @bullet\n\
+@item for triangles, rows 5 to 7 contain the nodes on the edges \
+opposite to the first, second and third vertex, as in the \
+@code{\"midedge\"} property of @code{msh2m_geometrical_properties};\n\
+@item for tetrahedra, rows 6 to 11 contain the nodes on the edges \
+(1,2), (2,3), (3,1), (4,1), (4,3), (4,2), which is the ordering used \
+by Gmsh for 10-node tetrahedra.\n\
+@end itemize\n\
+Similarly, @var{mesh2}.e has the rows of @var{mesh}.e followed by the \
+mid-edge node of each side edge (row 8) in 2D, or by the mid-edge \
+nodes of the edges (1,2), (2,3), (3,1) of each face (rows 11 to 13) \
+in 3D.  The region and boundary numbers are left where they are, so \
+the other functions of the package can still be applied to \
+@var{mesh2}.\n\
+\n\
+For 2D meshes, the mid-edge nodes of the side edges whose number is in \
+@var{sidelist} can be moved onto the curve @{@var{xpp}(s), \
+@var{ypp}(s)@}, given by two piecewise polynomials such as the ones \
+built by @code{catmullrom}; each node is placed at the parameter \
+halfway between the ones of the two vertices of the edge.  This is \
+useful, for instance, to obtain curved elements along the boundary of \
+a mesh built with @code{msh2m_mesh_along_spline}.\n\
+\n\
+If @var{mesh} is in the compact representation built by \
+@code{mshm_compact}, so is @var{mesh2}.\n\
+@seealso{msh2m_geometrical_properties, msh2m_mesh_along_spline, \
+msh2m_structured_mesh, msh3m_structured_mesh}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin != 1 && nargin != 4)
+    print_usage ();
+
+  msh::octave_mesh mesh (args(0), "mshm_promote_p2");
+  const int dim = mesh.dim ();
+  const msh::index_t erows = msh::standard_erows (dim);
+  if (mesh.compact () ? mesh.cview ().trows != dim + 1
+                      : mesh.view ().trows != dim + 2)
+    error ("mshm_promote_p2: the input mesh must be linear");
+  if (mesh.ne () > 0 && (mesh.label_rows () != erows
+                         || (mesh.compact () ? mesh.cview ().erows != dim
+                                             : mesh.view ().erows != erows)))
+    error ("mshm_promote_p2: the mesh field e must have %ld rows",
+           static_cast<long> (erows));
+
+  NDArray labels, xbreaks, xcoefs, ybreaks, ycoefs;
+  msh::pp_curve curve;
+  if (nargin == 4)
+    {
+      if (dim != 2)
+        error ("mshm_promote_p2: boundary projection is only available "
+               "for 2D meshes");
+      if (! args(1).isnumeric ())
+        error ("mshm_promote_p2: only numeric value admitted as sidelist.");
+      labels = args(1).array_value ();
+
+      msh::index_t xpieces, ypieces;
+      int xorder, yorder;
+      get_pp (args(2), xbreaks, xcoefs, xpieces, xorder);
+      get_pp (args(3), ybreaks, ycoefs, ypieces, yorder);
+      if (xpieces != ypieces || xorder != yorder
+          || ! std::equal (xbreaks.data (), xbreaks.data () + xpieces + 1,
+                           ybreaks.data ()))
+        error ("mshm_promote_p2: XPP and YPP must have the same breaks "
+               "and order");
+
+      curve.breaks = xbreaks.data ();
+      curve.coefs[0] = xcoefs.data ();
+      curve.coefs[1] = ycoefs.data ();
+      curve.pieces = xpieces;
+      curve.order = xorder;
+    }
+
+  // The mid-edge nodes of the boundary facets go after the node and
+  // tag rows of e: 1 row in 2D, 3 rows in 3D.
+  const msh::index_t nfe = dim == 2 ? 1 : 3;
+  const msh::pp_curve *pcurve = nargin == 4 ? &curve : 0;
+  octave_scalar_map a = args(0).scalar_map_value ();
+  NDArray p2;
+  if (mesh.compact ())
+    {
+      int32NDArray e2, t2;
+      promote (mesh.cview (), labels, pcurve, dim + nfe, p2, e2, t2);
+      a.setfield ("e", e2);
+      a.setfield ("t", t2);
+    }
+  else
+    {
+      NDArray e2, t2;
+      promote (mesh.view (), labels, pcurve, erows + nfe, p2, e2, t2);
+      a.setfield ("e", e2);
+      a.setfield ("t", t2);
+    }
+  a.setfield ("p", p2);
+  retval(0) = a;
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4, "left");
+%! mesh2 = mshm_promote_p2 (mesh);
+%! assert (columns (mesh2.p), 25)
+%! assert (mesh2.p(:,1:9), mesh.p)
+%! assert (mesh2.t(1:4,:), mesh.t)
+%! assert (rows (unique (mesh2.p', "rows")), 25)
+%! midedge = msh2m_geometrical_properties (mesh, "midedge");
+%! assert (reshape (mesh2.p(:,mesh2.t(5:7,:)), 2, 3, []), midedge)
+%! assert (mesh2.p(:,mesh2.e(8,:)), msh2m_geometrical_properties (mesh, "emidp"))
+
+%!test
+%! mesh = msh3m_structured_mesh ([0 1], [0 1], [0 1], 1, 1:6);
+%! mesh2 = mshm_promote_p2 (mesh);
+%! assert (columns (mesh2.p), 27)
+%! assert (size (mesh2.t), [11 6])
+%! assert (size (mesh2.e), [13 12])
+%! assert (mesh2.p(:,mesh2.t(6,:)), (mesh.p(:,mesh.t(1,:)) + mesh.p(:,mesh.t(2,:))) / 2)
+%! assert (mesh2.p(:,mesh2.e(13,:)), (mesh.p(:,mesh.e(3,:)) + mesh.p(:,mesh.e(1,:))) / 2)
+
+%!test
+%! theta = linspace (0, pi, 6);
+%! xc = cos (theta); yc = sin (theta);
+%! mesh = msh2m_mesh_along_spline (xc, yc, 11, 3, .1);
+%! s = 0:numel (xc) - 1;
+%! xpp = catmullrom (s, xc); ypp = catmullrom (s, yc);
+%! mesh2 = mshm_promote_p2 (mesh, 1, xpp, ypp);
+%! jj = find (mesh2.e(5,:) == 1);
+%! smid = (linspace (0, s(end), 11)(1:end-1) + linspace (0, s(end), 11)(2:end)) / 2;
+%! assert (mesh2.p(:,mesh2.e(8,jj)), [ppval(xpp, smid); ppval(ypp, smid)], 1e-10)
+*/
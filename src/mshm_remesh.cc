@@ -0,0 +1,234 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <string>
+
+#include "msh_kernels.h"
+#include "msh_octave.h"
+#include "msh_remesh.h"
+
+DEFUN_DLD (mshm_remesh, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {[@var{mesh2}, @var{metric2}]} = \
+mshm_remesh (@var{mesh}, @var{metric})\n\
+@deftypefnx {Function File} {[@var{mesh2}, @var{metric2}]} = \
+mshm_remesh (@var{mesh}, @var{metric}, @var{property}, @var{value}, \
+@dots{})\n\
+Adapt a triangular or tetrahedral mesh to a size field or to an \
+anisotropic metric.\n\
+\n\
+@var{metric} gives the desired size of the elements at each node of \
+@var{mesh}, either as a vector with the desired edge length at each \
+node, or as a matrix whose columns contain the upper triangle of a \
+symmetric positive definite tensor M, that is (M11, M12, M22) in 2D \
+and (M11, M12, M13, M22, M23, M33) in 3D.  An edge d has unit length \
+in the metric M when @code{d' * M * d = 1}, so that a size h \
+corresponds to the tensor @code{eye (dim) / h^2}.\n\
+\n\
+The mesh is modified by local operations: edges longer than \
+@code{sqrt (2)} in the metric are split, edges shorter than \
+@code{1 / sqrt (2)} are collapsed, interior edges are swapped (2D only) \
+and interior nodes are moved towards the centroid of their neighbours \
+when this improves the quality of the elements around them.  The \
+operations are applied in parallel to sets of non-overlapping \
+patches of elements; the result does not depend on the number of \
+threads.\n\
+\n\
+Nodes on the sides listed in @var{mesh}.e, on the interfaces between \
+regions and on the outer boundary are never moved.  In 2D such nodes \
+may only be removed by collapsing them along a straight boundary line \
+with a single side number, while in 3D they are never removed, so the \
+boundary of a 3D mesh can be refined but not coarsened.  Since there \
+are no edge or face swaps in 3D either, tetrahedral meshes are only \
+adapted by splits, interior collapses and smoothing, and flat \
+tetrahedra (slivers) are not removed.  The region \
+numbers in @var{mesh}.t and the rows of @var{mesh}.e of an edge or face \
+are inherited by the elements and sides obtained by splitting it.\n\
+\n\
+@var{mesh2} contains only the fields p, e and t.  @var{metric2} is the \
+metric at the nodes of @var{mesh2}, in the same form as @var{metric}, \
+linearly interpolated at the new nodes.  If @var{mesh} is in the \
+compact representation built by @code{mshm_compact}, so is \
+@var{mesh2}.\n\
+\n\
+The following properties can be set:\n\
+@table @asis\n\
+@item \"maxiter\"\n\
+maximum number of rounds of operations (default 20);\n\
+@item \"smooth\"\n\
+number of smoothing passes in each round (default 2);\n\
+@item \"qmin\"\n\
+an edge is not collapsed if this brings the quality of an element \
+below both this value and the quality of the worst element around it \
+before the collapse: a collapse may leave elements below this value \
+only if the worst element around the edge does not get worse \
+(default 0.3, the quality of an element being 1 when it is \
+equilateral in the metric).\n\
+@end table\n\
+@seealso{msh2m_equalize_mesh, msh2m_displacement_smoothing, \
+msh2m_jiggle_mesh}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin % 2 != 0)
+    print_usage ();
+
+  msh::octave_mesh mesh (args(0), "mshm_remesh");
+  const int dim = mesh.dim (), ms = msh::metric_size (dim);
+  const msh::index_t np = mesh.np ();
+  const NDArray e = mesh.e (), t = mesh.t ();
+  if (t.rows () != dim + 2)
+    error ("mshm_remesh: the input mesh must be linear");
+
+  if (! args(1).isnumeric ())
+    error ("mshm_remesh: METRIC must be a numeric array");
+  NDArray metric = args(1).array_value ();
+  const bool isotropic = ! (metric.rows () == ms && metric.cols () == np);
+  if (isotropic && ! ((metric.rows () == 1 || metric.cols () == 1)
+                      && metric.numel () == np))
+    error ("mshm_remesh: METRIC must have one entry or one %d components "
+           "column for each node", ms);
+
+  msh::remesh_options opt;
+  for (int nn = 2; nn < nargin; nn += 2)
+    {
+      if (! args(nn).is_string ())
+        error ("mshm_remesh: only string value admitted for properties.");
+      std::string prop = args(nn).string_value ();
+      if (! (args(nn+1).isnumeric () && args(nn+1).numel () == 1))
+        error ("mshm_remesh: the value of %s must be a scalar",
+               prop.c_str ());
+      double val = args(nn+1).double_value ();
+      if (prop == "maxiter" && val >= 0)
+        opt.maxiter = static_cast<int> (val);
+      else if (prop == "smooth" && val >= 0)
+        opt.smooth = static_cast<int> (val);
+      else if (prop == "qmin" && val >= 0 && val <= 1)
+        opt.qmin = val;
+      else
+        error ("mshm_remesh: invalid property or value: %s", prop.c_str ());
+    }
+
+  const msh::index_t erows = e.isempty () ? msh::standard_erows (dim)
+                                           : e.rows ();
+  msh::remesher r (dim, erows, t.rows ());
+  r.p.assign (mesh.p ().data (), mesh.p ().data () + dim * np);
+  r.e.assign (e.data (), e.data () + e.numel ());
+  r.t.assign (t.data (), t.data () + t.numel ());
+  r.metric.resize (ms * np);
+  const double *mvec = metric.data ();
+  for (msh::index_t i = 0; i < np; ++i)
+    {
+      double *M = &r.metric[ms * i];
+      if (isotropic)
+        {
+          if (! (mvec[i] > 0))
+            error ("mshm_remesh: the size at node %ld is not positive",
+                   static_cast<long> (i + 1));
+          std::fill (M, M + ms, 0.0);
+          M[0] = M[dim == 2 ? 2 : 3] = 1 / (mvec[i] * mvec[i]);
+          if (dim == 3)
+            M[5] = M[0];
+        }
+      else
+        {
+          std::copy (mvec + ms * i, mvec + ms * (i + 1), M);
+          if (! msh::metric_valid (dim, M))
+            error ("mshm_remesh: the metric at node %ld is not positive "
+                   "definite", static_cast<long> (i + 1));
+        }
+    }
+
+  r.run (opt);
+
+  const msh::index_t np2 = r.p.size () / dim;
+  NDArray p2 (dim_vector (dim, np2));
+  NDArray e2 (dim_vector (erows, r.e.size () / erows));
+  NDArray t2 (dim_vector (t.rows (), r.t.size () / t.rows ()));
+  std::copy (r.p.begin (), r.p.end (), p2.fortran_vec ());
+  std::copy (r.e.begin (), r.e.end (), e2.fortran_vec ());
+  std::copy (r.t.begin (), r.t.end (), t2.fortran_vec ());
+  retval(0) = mesh.compact () ? msh::compact_mesh (p2, e2, t2, "mshm_remesh")
+                              : msh::make_mesh (p2, e2, t2);
+
+  NDArray metric2;
+  if (isotropic)
+    {
+      metric2 = NDArray (metric.rows () == 1 ? dim_vector (1, np2)
+                                             : dim_vector (np2, 1));
+      for (msh::index_t i = 0; i < np2; ++i)
+        metric2(i) = 1 / std::sqrt (r.metric[ms * i]);
+    }
+  else
+    {
+      metric2 = NDArray (dim_vector (ms, np2));
+      std::copy (r.metric.begin (), r.metric.end (),
+                 metric2.fortran_vec ());
+    }
+  retval(1) = metric2;
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (linspace (0, 1, 5), linspace (0, 1, 5), 1, 1:4);
+%! [mesh2, h2] = mshm_remesh (mesh, .05 * (1 + 3 * mesh.p(1,:)));
+%! assert (columns (mesh2.p) > columns (mesh.p))
+%! assert (size (h2), [1 columns(mesh2.p)])
+%! area = msh2m_geometrical_properties (mesh2, "area");
+%! assert (sum (area), 1, 1e-12)
+%! assert (all (area > 0))
+%! for side = 1:4
+%!   jj = find (mesh2.e(5,:) == side);
+%!   len = sum (sqrt (sum ((mesh2.p(:,mesh2.e(1,jj)) - mesh2.p(:,mesh2.e(2,jj))).^2)));
+%!   assert (len, 1, 1e-12)
+%! endfor
+%! nn = msh2m_nodes_on_sides (mesh2, 1);
+%! assert (mesh2.p(2,nn), zeros (1, numel (nn)))
+
+%!test
+%! mesh1 = msh2m_structured_mesh (linspace (0, 1, 9), linspace (0, 1, 9), 1, 1:4);
+%! mesh2 = msh2m_structured_mesh (linspace (1, 2, 9), linspace (0, 1, 9), 2, 5:8);
+%! mesh = msh2m_join_structured_mesh (mesh1, mesh2, 2, 8);
+%! metric = repmat ([1/.3^2; 0; 1/.05^2], 1, columns (mesh.p));
+%! mesh2 = mshm_remesh (mesh, metric);
+%! area = msh2m_geometrical_properties (mesh2, "area");
+%! assert (sum (area(mesh2.t(4,:) == 1)), 1, 1e-12)
+%! assert (sum (area(mesh2.t(4,:) == 2)), 1, 1e-12)
+%! x = mesh2.p(1,:);
+%! assert (all (x(mesh2.t(1:3,mesh2.t(4,:) == 1)) <= 1))
+%! assert (all (x(mesh2.t(1:3,mesh2.t(4,:) == 2)) >= 1))
+%! y = mesh2.p(2,:)(mesh2.t(1:3,:));
+%! assert (max (max (y) - min (y)) < .1)
+
+%!test
+%! mesh = msh3m_structured_mesh (linspace (0, 1, 4), linspace (0, 1, 4), linspace (0, 1, 4), 1, 1:6);
+%! mesh2 = mshm_remesh (mesh, .15 * ones (1, columns (mesh.p)));
+%! vol = msh3m_geometrical_properties (mesh2, "area");
+%! assert (sum (vol), 1, 1e-12)
+%! assert (all (vol > 0))
+%! assert (sort (unique (mesh2.e(10,:))), 1:6)
+%! assert (columns (mesh2.t) > columns (mesh.t))
+
+%!error <METRIC> mshm_remesh (msh2m_structured_mesh (1:3, 1:3, 1, 1:4), [1 1])
+*/
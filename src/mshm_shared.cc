@@ -0,0 +1,660 @@
+/* Copyright (C) 2026 Carlo de Falco
+
+   This file is part of:
+   MSH - Meshing Software Package for Octave
+
+   MSH is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   MSH is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Publish a mesh structure to a POSIX shared memory object or to a
+// file, and attach to it from other processes.
+//
+// The segment holds a header, a table of entries and the data of each
+// numeric field, 64 bytes aligned.  Nested structures are stored as
+// entries with dotted names.  Attached arrays point into a private
+// mapping of the segment when Octave arrays can use a polymorphic
+// allocator: the pages are then shared with all the other processes
+// until one of them modifies the array, which only changes its own
+// copy.  With older Octave versions the data are copied.
+
+#include <octave/oct.h>
+#include <octave/oct-map.h>
+#include <octave/int16NDArray.h>
+#include <octave/int32NDArray.h>
+#include <octave/dSparse.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+#  include <memory_resource>
+#endif
+
+#if ! defined (_WIN32)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define MSH_HAVE_MMAP 1
+#endif
+
+namespace
+{
+  const char segment_magic[8] = {'M', 'S', 'H', 'S', 'E', 'G', '0', '1'};
+  const std::size_t alignment = 64, max_name = 64, max_dims = 8;
+
+  enum entry_type { type_double, type_int32, type_int16, type_char,
+                    type_bool, type_sparse };
+
+  struct segment_header
+  {
+    char magic[8];
+    uint64_t size, nentries, ready;
+  };
+
+  // For sparse entries dims holds rows, columns and nnz, and the data
+  // are the nonzeros followed by the row and column indices as int64.
+  struct segment_entry
+  {
+    char name[max_name];
+    uint64_t type, ndims, dims[max_dims], offset, bytes;
+  };
+
+  std::size_t
+  aligned (std::size_t n)
+  { return (n + alignment - 1) / alignment * alignment; }
+
+  std::size_t
+  element_size (int type)
+  {
+    switch (type)
+      {
+      case type_int32:
+        return 4;
+      case type_int16:
+        return 2;
+      case type_char:
+      case type_bool:
+        return 1;
+      default:
+        return 8;
+      }
+  }
+
+  // A field to be published, with its position in the data area.
+  struct field
+  {
+    segment_entry entry;
+    octave_value value;
+  };
+
+  void
+  collect_fields (const octave_scalar_map& s, const std::string& prefix,
+                  std::vector<field>& fields)
+  {
+    for (octave_scalar_map::const_iterator it = s.begin ();
+         it != s.end (); ++it)
+      {
+        const std::string name = prefix + s.key (it);
+        const octave_value& v = s.contents (it);
+        if (v.isstruct () && v.numel () == 1)
+          {
+            collect_fields (v.scalar_map_value (), name + ".", fields);
+            continue;
+          }
+
+        field f;
+        std::memset (&f.entry, 0, sizeof (segment_entry));
+        if (name.size () >= max_name)
+          error ("mshm_shared: the field name %s is too long", name.c_str ());
+        std::strcpy (f.entry.name, name.c_str ());
+        f.value = v;
+
+        if (v.issparse () && v.is_double_type () && v.isreal ())
+          f.entry.type = type_sparse;
+        else if (v.is_double_type () && v.isreal ())
+          f.entry.type = type_double;
+        else if (v.is_int32_type ())
+          f.entry.type = type_int32;
+        else if (v.is_int16_type ())
+          f.entry.type = type_int16;
+        else if (v.is_string ())
+          f.entry.type = type_char;
+        else if (v.islogical () && ! v.issparse ())
+          f.entry.type = type_bool;
+        else
+          {
+            warning ("mshm_shared: field %s of class %s is not published",
+                     name.c_str (), v.class_name ().c_str ());
+            continue;
+          }
+
+        const dim_vector dv = v.dims ();
+        if (dv.ndims () > int (max_dims))
+          error ("mshm_shared: field %s has too many dimensions",
+                 name.c_str ());
+        if (f.entry.type == type_sparse)
+          {
+            const SparseMatrix a = v.sparse_matrix_value ();
+            f.entry.ndims = 3;
+            f.entry.dims[0] = a.rows ();
+            f.entry.dims[1] = a.cols ();
+            f.entry.dims[2] = a.nnz ();
+            f.entry.bytes = 8 * (2 * a.nnz () + a.cols () + 1);
+          }
+        else
+          {
+            f.entry.ndims = dv.ndims ();
+            for (int k = 0; k < dv.ndims (); ++k)
+              f.entry.dims[k] = dv(k);
+            f.entry.bytes = element_size (f.entry.type) * v.numel ();
+          }
+        fields.push_back (f);
+      }
+  }
+
+  template <typename A>
+  void
+  copy_data (const A& a, char *dst)
+  { std::memcpy (dst, a.data (), a.numel () * sizeof (*a.data ())); }
+
+  void
+  write_field (const field& f, char *dst)
+  {
+    const octave_value& v = f.value;
+    switch (f.entry.type)
+      {
+      case type_double:
+        copy_data (v.array_value (), dst);
+        break;
+      case type_int32:
+        copy_data (v.int32_array_value (), dst);
+        break;
+      case type_int16:
+        copy_data (v.int16_array_value (), dst);
+        break;
+      case type_char:
+        copy_data (v.char_array_value (), dst);
+        break;
+      case type_bool:
+        copy_data (v.bool_array_value (), dst);
+        break;
+      default:
+        {
+          const SparseMatrix a = v.sparse_matrix_value ();
+          const octave_idx_type nnz = a.nnz (), nc = a.cols ();
+          std::memcpy (dst, a.data (), 8 * nnz);
+          int64_t *ridx = reinterpret_cast<int64_t *> (dst + 8 * nnz);
+          int64_t *cidx = ridx + nnz;
+          for (octave_idx_type q = 0; q < nnz; ++q)
+            ridx[q] = a.ridx (q);
+          for (octave_idx_type c = 0; c <= nc; ++c)
+            cidx[c] = a.cidx (c);
+        }
+      }
+  }
+
+#if defined (MSH_HAVE_MMAP)
+
+  // Names with a single leading slash are POSIX shared memory objects,
+  // anything else is a file.
+  bool
+  is_shm_name (const std::string& name)
+  { return name.size () > 1 && name[0] == '/'
+      && name.find ('/', 1) == std::string::npos; }
+
+  class fd_guard
+  {
+  public:
+    explicit fd_guard (int fd) : m_fd (fd) { }
+    ~fd_guard (void) { if (m_fd >= 0) ::close (m_fd); }
+    int get (void) const { return m_fd; }
+  private:
+    fd_guard (const fd_guard&);
+    fd_guard& operator = (const fd_guard&);
+    int m_fd;
+  };
+
+  // A mapping of a segment, unmapped when the last array pointing into
+  // it is released.
+  class segment_mapping
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+    : public std::pmr::memory_resource
+#endif
+  {
+  public:
+
+    segment_mapping (void *addr, std::size_t len)
+      : m_addr (static_cast<char *> (addr)), m_len (len), m_count (1) { }
+
+    char *data (void) const { return m_addr; }
+    std::size_t size (void) const { return m_len; }
+
+    void acquire (void) { ++m_count; }
+
+    void
+    release (void)
+    {
+      if (--m_count == 0)
+        delete this;
+    }
+
+  private:
+
+    ~segment_mapping (void) { ::munmap (m_addr, m_len); }
+
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+    // Copies of the attached arrays made by Octave use the same
+    // allocator, so allocations outside of the segment are served by
+    // the default resource; they keep the mapping alive as well, since
+    // the allocator refers to it.
+    void *
+    do_allocate (std::size_t bytes, std::size_t align)
+    {
+      acquire ();
+      return std::pmr::new_delete_resource ()->allocate (bytes, align);
+    }
+
+    void
+    do_deallocate (void *p, std::size_t bytes, std::size_t align)
+    {
+      char *c = static_cast<char *> (p);
+      if (! (c >= m_addr && c < m_addr + m_len))
+        std::pmr::new_delete_resource ()->deallocate (p, bytes, align);
+      release ();
+    }
+
+    bool
+    do_is_equal (const std::pmr::memory_resource& other) const noexcept
+    { return this == &other; }
+#endif
+
+    char *m_addr;
+    std::size_t m_len;
+    std::atomic<std::size_t> m_count;
+  };
+
+  template <typename T, typename A>
+  A
+  attach_array (segment_mapping *map, const segment_entry& en,
+                const dim_vector& dv)
+  {
+    T *ptr = reinterpret_cast<T *> (map->data () + en.offset);
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+    if (dv.numel () > 0)
+      {
+        map->acquire ();
+        return A (Array<T> (ptr, dv, std::pmr::polymorphic_allocator<T> (map)));
+      }
+#endif
+    A a (dv);
+    std::copy (ptr, ptr + dv.numel (), a.fortran_vec ());
+    return a;
+  }
+
+  // True if the row and column indices of the sparse entry en, stored
+  // after its nonzeros at src, describe a valid compressed column
+  // matrix, which Octave does not check: column starts going from 0 up
+  // to nnz, and row indices increasing within each column and below the
+  // number of rows.
+  bool
+  valid_sparse_indices (const char *src, const segment_entry& en)
+  {
+    const uint64_t nr = en.dims[0], nc = en.dims[1], nnz = en.dims[2];
+    if (en.ndims != 2
+        || nr > uint64_t (std::numeric_limits<octave_idx_type>::max ())
+        || nc >= uint64_t (std::numeric_limits<octave_idx_type>::max ())
+        || nnz > uint64_t (std::numeric_limits<octave_idx_type>::max ()))
+      return false;
+    const int64_t *ridx = reinterpret_cast<const int64_t *> (src + 8 * nnz);
+    const int64_t *cidx = ridx + nnz;
+    if (cidx[0] != 0 || uint64_t (cidx[nc]) != nnz)
+      return false;
+    for (uint64_t c = 0; c < nc; ++c)
+      {
+        if (cidx[c + 1] < cidx[c] || uint64_t (cidx[c + 1]) > nnz)
+          return false;
+        for (int64_t q = cidx[c]; q < cidx[c + 1]; ++q)
+          if (ridx[q] < 0 || uint64_t (ridx[q]) >= nr
+              || (q > cidx[c] && ridx[q] <= ridx[q - 1]))
+            return false;
+      }
+    return true;
+  }
+
+  octave_value
+  attach_field (segment_mapping *map, const segment_entry& en)
+  {
+    dim_vector dv;
+    dv.resize (en.ndims);
+    for (uint64_t k = 0; k < en.ndims; ++k)
+      dv(k) = en.dims[k];
+
+    switch (en.type)
+      {
+      case type_double:
+        return attach_array<double, NDArray> (map, en, dv);
+      case type_int32:
+        return attach_array<octave_int32, int32NDArray> (map, en, dv);
+      case type_int16:
+        return attach_array<octave_int16, int16NDArray> (map, en, dv);
+      case type_char:
+        return octave_value (attach_array<char, charNDArray> (map, en, dv),
+                             '\'');
+      case type_bool:
+        return attach_array<bool, boolNDArray> (map, en, dv);
+      default:
+        {
+          const octave_idx_type nr = en.dims[0], nc = en.dims[1];
+          const octave_idx_type nnz = en.dims[2];
+          const char *src = map->data () + en.offset;
+          const int64_t *ridx
+            = reinterpret_cast<const int64_t *> (src + 8 * nnz);
+          const int64_t *cidx = ridx + nnz;
+          SparseMatrix a (nr, nc, nnz);
+          std::memcpy (a.data (), src, 8 * nnz);
+          for (octave_idx_type q = 0; q < nnz; ++q)
+            a.ridx (q) = ridx[q];
+          for (octave_idx_type c = 0; c <= nc; ++c)
+            a.cidx (c) = cidx[c];
+          return a;
+        }
+      }
+  }
+
+  // Store v at the dotted path name of s.
+  void
+  insert_field (octave_scalar_map& s, const std::string& name,
+                const octave_value& v)
+  {
+    const std::size_t dot = name.find ('.');
+    if (dot == std::string::npos)
+      {
+        s.setfield (name, v);
+        return;
+      }
+    const std::string head = name.substr (0, dot);
+    octave_scalar_map sub;
+    if (s.isfield (head))
+      sub = s.getfield (head).scalar_map_value ();
+    insert_field (sub, name.substr (dot + 1), v);
+    s.setfield (head, sub);
+  }
+
+  void
+  publish (const octave_scalar_map& mesh, const std::string& name)
+  {
+    std::vector<field> fields;
+    collect_fields (mesh, "", fields);
+
+    std::size_t size = aligned (sizeof (segment_header)
+                                + fields.size () * sizeof (segment_entry));
+    for (std::size_t k = 0; k < fields.size (); ++k)
+      {
+        fields[k].entry.offset = size;
+        size += aligned (fields[k].entry.bytes);
+      }
+
+    const bool shm = is_shm_name (name);
+    const int flags = O_RDWR | O_CREAT | O_EXCL;
+    fd_guard fd (shm ? ::shm_open (name.c_str (), flags, 0644)
+                     : ::open (name.c_str (), flags, 0644));
+    if (fd.get () < 0)
+      error ("mshm_shared: cannot create %s: %s", name.c_str (),
+             std::strerror (errno));
+    if (::ftruncate (fd.get (), size) != 0)
+      {
+        const int err = errno;
+        shm ? ::shm_unlink (name.c_str ()) : ::unlink (name.c_str ());
+        error ("mshm_shared: cannot resize %s: %s", name.c_str (),
+               std::strerror (err));
+      }
+
+    void *addr = ::mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd.get (), 0);
+    if (addr == MAP_FAILED)
+      {
+        const int err = errno;
+        shm ? ::shm_unlink (name.c_str ()) : ::unlink (name.c_str ());
+        error ("mshm_shared: cannot map %s: %s", name.c_str (),
+               std::strerror (err));
+      }
+
+    char *base = static_cast<char *> (addr);
+    segment_header *h = reinterpret_cast<segment_header *> (base);
+    segment_entry *table
+      = reinterpret_cast<segment_entry *> (base + sizeof (segment_header));
+    std::memcpy (h->magic, segment_magic, sizeof (segment_magic));
+    h->size = size;
+    h->nentries = fields.size ();
+    for (std::size_t k = 0; k < fields.size (); ++k)
+      {
+        table[k] = fields[k].entry;
+        write_field (fields[k], base + fields[k].entry.offset);
+      }
+
+    // Readers check this flag last, so they never see a partial mesh.
+    __atomic_store_n (&h->ready, uint64_t (1), __ATOMIC_RELEASE);
+    if (! shm)
+      ::msync (addr, size, MS_SYNC);
+    ::munmap (addr, size);
+  }
+
+  octave_scalar_map
+  attach (const std::string& name)
+  {
+    const bool shm = is_shm_name (name);
+    fd_guard fd (shm ? ::shm_open (name.c_str (), O_RDONLY, 0)
+                     : ::open (name.c_str (), O_RDONLY));
+    if (fd.get () < 0)
+      error ("mshm_shared: cannot open %s: %s", name.c_str (),
+             std::strerror (errno));
+
+    struct stat st;
+    if (::fstat (fd.get (), &st) != 0
+        || std::size_t (st.st_size) < sizeof (segment_header))
+      error ("mshm_shared: %s is not a published mesh", name.c_str ());
+    const std::size_t size = st.st_size;
+
+    // A private writable mapping, so that modifying an attached array
+    // in place never changes the segment.
+    void *addr = ::mmap (0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                         fd.get (), 0);
+    if (addr == MAP_FAILED)
+      error ("mshm_shared: cannot map %s: %s", name.c_str (),
+             std::strerror (errno));
+    segment_mapping *map = new segment_mapping (addr, size);
+
+    const char *base = map->data ();
+    const segment_header *h = reinterpret_cast<const segment_header *> (base);
+    const segment_entry *table
+      = reinterpret_cast<const segment_entry *> (base + sizeof (segment_header));
+    bool valid = std::memcmp (h->magic, segment_magic,
+                              sizeof (segment_magic)) == 0
+                 && __atomic_load_n (&h->ready, __ATOMIC_ACQUIRE) == 1
+                 && h->size == size
+                 && h->nentries <= (size - sizeof (segment_header))
+                                   / sizeof (segment_entry);
+    for (uint64_t k = 0; valid && k < h->nentries; ++k)
+      {
+        const segment_entry& en = table[k];
+        valid = en.type <= type_sparse && en.ndims >= 2
+                && en.ndims <= max_dims
+                && std::memchr (en.name, 0, max_name) != 0
+                && en.offset % alignment == 0 && en.offset <= size
+                && en.bytes <= size - en.offset;
+        // The sizes are checked before each product, so that huge
+        // dimensions cannot wrap around to the size of the data.
+        uint64_t bytes = 0;
+        if (valid && en.type == type_sparse)
+          {
+            const uint64_t words = size / 8;
+            valid = en.dims[2] <= words / 2
+                    && en.dims[1] < words - 2 * en.dims[2];
+            bytes = 8 * (2 * en.dims[2] + en.dims[1] + 1);
+          }
+        else if (valid)
+          {
+            bytes = element_size (en.type);
+            for (uint64_t d = 0; valid && d < en.ndims; ++d)
+              {
+                valid = en.dims[d] == 0 || bytes <= UINT64_MAX / en.dims[d];
+                bytes *= en.dims[d];
+              }
+          }
+        valid = valid && bytes == en.bytes
+                && (en.type != type_sparse
+                    || valid_sparse_indices (base + en.offset, en));
+      }
+    if (! valid)
+      {
+        map->release ();
+        error ("mshm_shared: %s is not a published mesh or is still being "
+               "written", name.c_str ());
+      }
+
+    octave_scalar_map mesh;
+    for (uint64_t k = 0; k < h->nentries; ++k)
+      insert_field (mesh, table[k].name, attach_field (map, table[k]));
+    map->release ();
+    return mesh;
+  }
+
+  void
+  unlink_segment (const std::string& name)
+  {
+    const int status = is_shm_name (name) ? ::shm_unlink (name.c_str ())
+                                          : ::unlink (name.c_str ());
+    if (status != 0)
+      error ("mshm_shared: cannot remove %s: %s", name.c_str (),
+             std::strerror (errno));
+  }
+
+#endif
+}
+
+DEFUN_DLD (mshm_shared, args, , "-*- texinfo -*-\n\
+@deftypefn {Function File} {} mshm_shared (\"publish\", @var{mesh}, \
+@var{name})\n\
+@deftypefnx {Function File} {[@var{mesh}]} = mshm_shared (\"attach\", \
+@var{name})\n\
+@deftypefnx {Function File} {} mshm_shared (\"unlink\", @var{name})\n\
+Share a mesh among Octave processes running on the same machine.\n\
+\n\
+@code{mshm_shared (\"publish\", @var{mesh}, @var{name})} writes all \
+the fields of the structure @var{mesh} to a new segment.  If @var{name} \
+has the form @code{\"/name\"}, with no other slash, the segment is a \
+POSIX shared memory object, otherwise it is a file with that name.  \
+Topological and geometrical properties stored in @var{mesh}, for \
+instance by @code{msh2m_topological_properties} or \
+@code{mshm_boundary_index}, are published as well, so that other \
+processes need not compute them again.  Fields which are real double, \
+int32, int16, logical or char arrays, real sparse matrices or \
+structures of such fields are published; other fields are skipped with \
+a warning.  An existing segment is never overwritten.\n\
+\n\
+@code{mshm_shared (\"attach\", @var{name})} returns the published mesh. \
+When Octave supports polymorphic allocators, the arrays in the result \
+are not copied but point to the pages of the segment, which are shared \
+by all the attached processes; an array modified by a process is \
+copied for that process only.  Sparse matrices are always copied.\n\
+\n\
+@code{mshm_shared (\"unlink\", @var{name})} removes the segment; \
+processes already attached to it can still use their mesh.\n\
+@seealso{mshm_compact, mshm_batch}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if (nargin < 2 || ! args(0).is_string ())
+    print_usage ();
+  const std::string action = args(0).string_value ();
+  if (! args(nargin - 1).is_string ())
+    error ("mshm_shared: NAME must be a string");
+  const std::string name = args(nargin - 1).string_value ();
+
+#if defined (MSH_HAVE_MMAP)
+  if (action == "publish" && nargin == 3)
+    {
+      if (! (args(1).isstruct () && args(1).numel () == 1))
+        error ("mshm_shared: MESH must be a structure");
+      publish (args(1).scalar_map_value (), name);
+    }
+  else if (action == "attach" && nargin == 2)
+    retval(0) = attach (name);
+  else if (action == "unlink" && nargin == 2)
+    unlink_segment (name);
+  else
+    print_usage ();
+#else
+  error ("mshm_shared: shared memory is not supported on this system");
+#endif
+
+  return retval;
+}
+
+/*
+%!test
+%! mesh = msh2m_structured_mesh (0:.5:1, 0:.5:1, 1, 1:4);
+%! [mesh.v2v, mesh.pattern] = msh2m_topological_properties (mesh, "v2v", "pattern");
+%! mesh.area = msh2m_geometrical_properties (mesh, "area");
+%! name = tempname ();
+%! unwind_protect
+%!   mshm_shared ("publish", mesh, name);
+%!   mesh2 = mshm_shared ("attach", name);
+%!   assert (mesh2, mesh)
+%!   mesh2.p(1,1) = 10;
+%!   assert (mshm_shared ("attach", name), mesh)
+%! unwind_protect_cleanup
+%!   mshm_shared ("unlink", name);
+%! end_unwind_protect
+
+%!test
+%! mesh = mshm_compact (msh3m_structured_mesh (0:.5:1, 0:.5:1, 0:.5:1, 1, 1:6));
+%! mesh.shg = msh3m_geometrical_properties (mshm_expand (mesh), "shg");
+%! mesh.name = "cube";
+%! name = sprintf ("/msh_test_%d", getpid ());
+%! unwind_protect
+%!   mshm_shared ("publish", mesh, name);
+%!   fail ("mshm_shared (\"publish\", mesh, name)", "cannot create");
+%!   assert (mshm_shared ("attach", name), mesh)
+%! unwind_protect_cleanup
+%!   mshm_shared ("unlink", name);
+%! end_unwind_protect
+
+%!test
+%! name = tempname ();
+%! unwind_protect
+%!   mshm_shared ("publish", struct ("a", sparse ([1 0; 0 2])), name);
+%!   ## Move the first row index of a, after the 32 byte header and the
+%!   ## offset of the data in the first entry, out of range.
+%!   fid = fopen (name, "r+");
+%!   fseek (fid, 176);
+%!   offset = fread (fid, 1, "uint64");
+%!   fseek (fid, offset + 16);
+%!   fwrite (fid, 5, "int64");
+%!   fclose (fid);
+%!   fail ("mshm_shared (\"attach\", name)", "not a published mesh");
+%! unwind_protect_cleanup
+%!   mshm_shared ("unlink", name);
+%! end_unwind_protect
+
+%!error <cannot open> mshm_shared ("attach", "/msh_no_such_segment")
+*/